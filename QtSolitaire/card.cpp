@@ -1,17 +1,14 @@
 #include "card.h"
+#include "cardatlas.h"
 #include "constants.h"
+#include "logging.h"
+#include "renderstats.h"
+#include "trace.h"
 
-#include <QApplication>
-#include <QCursor>
-#include <QDrag>
-#include <QGraphicsSceneMouseEvent>
-#include <QMimeData>
+#include <QGraphicsSceneHoverEvent>
 #include <QPainter>
-#include <QRandomGenerator>
-#include <QSvgRenderer>
-#include <QWidget>
+#include <QVector>
 #include <QDebug>
-#include <QGraphicsSvgItem>
 
 /******************************************************************************
   * Card Implementation
@@ -23,69 +20,26 @@
   * @param parent object
   */
 Card::Card(CardValue v, Suit s, QGraphicsItem *parent)
-    :QGraphicsObject(parent)
+    :QGraphicsItem(parent)
+    ,mId{makeCardId(s, v)}
     ,mFaceUp(true)
-    ,mMouseDown(false)
     ,mHover(false)
-    ,mValue(v)
-    ,mSuit(s)
-    ,mImage{nullptr}
-    ,mBackImage{nullptr}
-    ,mColor{Qt::red}
 {
-    if (mSuit == Suit::CLUB || mSuit == Suit::SPADE) {
-        mColor = Qt::black;
-    }
-    setCursor(Qt::OpenHandCursor);
-    setAcceptedMouseButtons(Qt::LeftButton);
+    setAcceptedMouseButtons(Qt::NoButton);
     setAcceptHoverEvents(true);
 
-    const char *imgPath = getImagePath();
-    if (imgPath != nullptr) {
-        mImage = new QGraphicsSvgItem(getImagePath(), this);
-        mImage->setParent(this);
-        mImage->setScale(SVG_SCALEF);
-        mImage->setTransformOriginPoint(QPointF(-CARD_WIDTH/2, -3-CARD_HEIGHT/2));
-        mImage->setVisible(true);
-    }
-
-    mBackImage = new QGraphicsSvgItem(":/images/Card-Back.svg", this);
-    mBackImage->setParent(this);
-    mBackImage->setScale(SVG_SCALEF);
-    mBackImage->setTransformOriginPoint(QPointF(-CARD_WIDTH/2, -3-CARD_HEIGHT/2));
-    mBackImage->setVisible(false);
-
-    mPaintText = QString(getValueText()) + QString(getSuitChar());
-
-    setToolTip(QString("%1").arg(mPaintText));
-
-    if (debugLevel >= DEBUG_LEVEL::VERBOSE) {
-        qDebug() << "Created Card" <<  static_cast<QGraphicsItem*>(this);
-    }
+    qCDebug(lcCard) << "Created Card" << static_cast<QGraphicsItem*>(this);
 }
 
 Card::~Card() {
 
-    // Note: these images are deleted via being children of the card ;)
-    //       Refer to https://doc.qt.io/qt-6/objecttrees.html if
-    //       you are unfamiliar with qt memory management
-    //    delete mImage;
-    //    delete mBackImage;
-    if (debugLevel >= DEBUG_LEVEL::VERBOSE) {
-        qDebug() << "Destroyed Card" << static_cast<QGraphicsItem*>(this);
-    }
+    qCDebug(lcCard) << "Destroyed Card" << static_cast<QGraphicsItem*>(this);
 }
 
 void Card::setFaceUp(bool faceUp)
 {
     if (faceUp != mFaceUp) {
         mFaceUp = faceUp;
-        if (mImage) {
-            mImage->setVisible(faceUp);
-        }
-        if (mBackImage) {
-            mBackImage->setVisible(!faceUp);
-        }
         update();
     }
 }
@@ -96,163 +50,60 @@ QRectF Card::boundingRect() const
 
 }
 
+/**
+ * @brief paint the card: its picture is pre-rendered in the CardAtlas, so this is one blit
+ */
 void Card::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
 {
-    int penWidth = mHover ? 2 : 1;
-
     Q_UNUSED(option);
     Q_UNUSED(widget);
-    painter->save();
-    if (debugLevel == DEBUG_LEVEL::VERBOSE && mValue == CardValue::JACK) {
-        qDebug() << QString{"Painted Card %1 at {%2,%3}"}
-                        .arg(mPaintText)
-                        .arg(this->scenePos().rx()).arg(this->scenePos().ry());
-    }
-
-    // Draw Drop shadow
-    painter->setPen(Qt::NoPen);
-    painter->setBrush(Qt::darkGray);
-    painter->drawRoundedRect(boundingRect(), CARD_RADIUS, CARD_RADIUS);
-
-    // Draw square
-    painter->setPen(QPen(Qt::black, penWidth));
-    painter->setBrush(QBrush(Qt::white));
-    painter->drawRoundedRect(boundingRect(), CARD_RADIUS, CARD_RADIUS);
-
-    if (mImage) {
-        // NOTE: QGraphicsSvgItem has it's own paint method!
-        //       Code below works, but performs a second paint on the image.
-        //       We don't need to do anything here...
-    //    painter->scale(SVG_SCALEF, SVG_SCALEF);
-    //    painter->translate(QPointF(-(CARD_WIDTH/(SVG_SCALEF*2)),  -(CARD_HEIGHT/(SVG_SCALEF*2))));
-    //    mImage->paint(painter, option, widget);
-
-        if (mHover) {
-
-        }
-
-    } else {
-        // And the text
-        painter->setPen(mColor);
-        painter->drawText(QPoint{-(CARD_WIDTH/2)+SHDW+1, -(CARD_WIDTH/2)+SHDW+1}, mPaintText);
-    }
-
-
-    painter->restore();
-}
-
-// Signal definitions appear in the moc output, no need to define them.
-// void Card::clicked(Card& card) { }
-
-void Card::mousePressEvent(QGraphicsSceneMouseEvent *event)
-{
-// Docs say default impl handles selection and moving...
-//    QGraphicsItem::mousePressEvent(event);
-    if (event->button() == Qt::LeftButton)
-    {
-        mMouseDown = true;
-        event->accept();
-        setCursor(Qt::ClosedHandCursor);
-    }
-    else
-    {
-        event->ignore();
-    }
-}
-
-void Card::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
-{
-    QGraphicsItem::mouseMoveEvent(event);
-    if (QLineF(event->screenPos(), event->buttonDownScreenPos(Qt::LeftButton))
-            .length() < QApplication::startDragDistance()) {
-        return;
-    }
-
-    QDrag *drag = new QDrag(event->widget());
-    QMimeData *mime = new QMimeData;
-    drag->setMimeData(mime);
-
-    static int n = 0;
-    mime->setText(mPaintText);
-    mime->setColorData(mColor);
-
-    // Serialize a pointer to the card into the mime data
-    QByteArray itemData;
-    QDataStream dataStream{&itemData, QIODevice::WriteOnly};
-    dataStream << this;
-
-    mime->setData(CARD_MIME_TYPE, itemData);
-
-    if (mImage) {
-        QSvgRenderer *renderer = mImage->renderer();
-
-        QImage image(CARD_WIDTH, CARD_HEIGHT, QImage::Format_ARGB32);
-        image.fill(0xaaA08080);  // partly transparent red-ish background
-
-        QPainter painter(&image);
-        renderer->render(&painter);
-
-        mime->setImageData(image);
-
-        drag->setPixmap(QPixmap::fromImage(image).scaled(CARD_WIDTH, CARD_HEIGHT));
-        drag->setHotSpot(QPoint(CARD_WIDTH/2,CARD_HEIGHT/2));
-
-    } else {
-
-        QPixmap pixmap(CARD_WIDTH, CARD_HEIGHT);
-        pixmap.fill(mColor);
-
-        QPainter painter(&pixmap);
-        painter.translate(CARD_WIDTH/2, CARD_HEIGHT/2);
-        painter.setRenderHint(QPainter::Antialiasing);
-        paint(&painter, nullptr, nullptr);
-        painter.end();
-
-        //Creates a mask where white is non-transparent.  Interesting
-        pixmap.setMask(pixmap.createMaskFromColor(Qt::white, Qt::MaskOutColor));
-
-        drag->setPixmap(pixmap);
-        drag->setHotSpot(QPoint(CARD_WIDTH/2, CARD_HEIGHT/2));
-
-    }
-
-    drag->exec(Qt::MoveAction);
-    setCursor(Qt::OpenHandCursor);
+    TRACE_SPAN("paint", "Card::paint");
+    RenderStats::countPaint();
+    CardAtlas::draw(painter, boundingRect(), mId, mFaceUp, mHover);
 }
 
 void Card::hoverEnterEvent(QGraphicsSceneHoverEvent *event)
 {
     mHover = true;
+    update();
     QGraphicsItem::hoverEnterEvent(event);
 }
 
 void Card::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
 {
     mHover = false;
-    mMouseDown = false;
+    update();
     QGraphicsItem::hoverLeaveEvent(event);
 }
 
 
-void Card::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+/**
+ * @brief cardText - short name of a card, e.g. "10♥", used for its face and undo text
+ */
+QString Card::cardText(CardId id)
 {
-    if (mMouseDown) {
-        mMouseDown = false;
-        emit clicked(*this);
-    }
-    setCursor(Qt::OpenHandCursor);
-    QGraphicsItem::mouseReleaseEvent(event);
+    return QString(valueText(cardValue(id))) + QString(suitChar(cardSuit(id)));
 }
 
-void Card::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
+/**
+ * @brief cardName - cardText() of every card, made once and shared by all card items
+ */
+const QString& Card::cardName(CardId id)
 {
-    emit doubleClicked(*this);
+    static const QVector<QString> names = [] {
+        QVector<QString> table;
+        table.reserve(NUM_CARDS);
+        for (int i = 0; i < NUM_CARDS; ++i) {
+            table.append(cardText(static_cast<CardId>(i)));
+        }
+        return table;
+    }();
+    return names[id];
 }
 
+QChar Card::suitChar(Suit suit) {
 
-QChar Card::getSuitChar() {
-    
-    switch(mSuit) {
+    switch(suit) {
     case Suit::HEART: return QChar::fromUcs2(0x2665); break;
     case Suit::DIAMOND: return QChar::fromUcs2(0x2666); break;
     case Suit::CLUB: return QChar::fromUcs2(0x2663);
@@ -261,9 +112,9 @@ QChar Card::getSuitChar() {
 }
 
 
-const char *Card::getValueText() {
+const char *Card::valueText(CardValue value) {
 
-    switch(mValue) {
+    switch(value) {
         case CardValue::ACE: return "A"; break;
         case CardValue::TWO: return "2"; break;
         case CardValue::THREE: return "3"; break;
@@ -280,57 +131,3 @@ const char *Card::getValueText() {
     }
 
 }
-
-const char *Card::getImagePath() {
-    switch (mSuit) {
-    case Suit::HEART:
-        switch(mValue) {
-        case CardValue::KING:  return ":/images/King-Hearts.svg"; break;
-        case CardValue::QUEEN: return ":/images/Queen-Hearts.svg"; break;
-        case CardValue::JACK:  return ":/images/Jack-Hearts.svg"; break;
-        default:    return nullptr;
-        }
-        break;
-        
-    case Suit::DIAMOND:
-        switch(mValue) {
-        case CardValue::KING:  return ":/images/King-Diamonds.svg"; break;
-        case CardValue::QUEEN: return ":/images/Queen-Diamonds.svg"; break;
-        case CardValue::JACK:  return ":/images/Jack-Diamonds.svg"; break;
-        default:    return nullptr;
-        }
-        break;
-    case Suit::CLUB:
-        switch(mValue) {
-        case CardValue::KING:  return ":/images/King-Clubs.svg"; break;
-        case CardValue::QUEEN: return ":/images/Queen-Clubs.svg"; break;
-        case CardValue::JACK:  return ":/images/Jack-Clubs.svg"; break;
-        default:    return nullptr;
-        }
-        break;
-    case Suit::SPADE:
-        switch(mValue) {
-        case CardValue::KING:  return ":/images/King-Spades.svg"; break;
-        case CardValue::QUEEN: return ":/images/Queen-Spades.svg"; break;
-        case CardValue::JACK:  return ":/images/Jack-Spades.svg"; break;
-        default:    return nullptr;
-        }
-        break;
-    }
-
-}
-
-QDataStream & operator << (QDataStream & s, const Card *cardptr)
-{
-    /** WARNING: non-portable code **/
-    qulonglong ptrval(*reinterpret_cast<qulonglong *>(&cardptr));
-    return s << ptrval;
-}
-QDataStream & operator >> (QDataStream & s, Card *& cardptr)
-{
-    qulonglong ptrval;
-    s >> ptrval;
-    cardptr = *reinterpret_cast<Card **>(&ptrval);
-    return s;
-}
-
@@ -1,99 +1,60 @@
 #ifndef CARD_H
 #define CARD_H
 
-#include "enumiterator.h"
+#include "cardtypes.h"
 
 #include <QChar>
 #include <QColor>
-#include <QGraphicsObject>
-
-QT_FORWARD_DECLARE_CLASS(QGraphicsSvgItem)
-
-enum class CardValue {
-    ACE = 1,
-    TWO,
-    THREE,
-    FOUR,
-    FIVE,
-    SIX,
-    SEVEN,
-    EIGHT,
-    NINE,
-    TEN,
-    JACK,
-    QUEEN,
-    KING
-};
-typedef enumIterator<CardValue, CardValue::ACE, CardValue::KING> CardValueIterator;
-
-enum class Suit {
-    HEART,
-    DIAMOND,
-    SPADE,
-    CLUB
-};
-typedef enumIterator<Suit, Suit::HEART, Suit::CLUB> SuitIterator;
-
-enum class Colors {
-    RED,
-    BLACK
-};
-typedef enumIterator<Colors, Colors::RED, Colors::BLACK> ColorsIterator;
-
-class Card : public QGraphicsObject
+#include <QGraphicsItem>
+#include <QString>
+
+/**
+ * @brief The Card class is the scene item of one playing card
+ *
+ * Cards are lean: a plain QGraphicsItem with no QObject, no child items, no tooltip or
+ * cursor of its own, holding only its CardId and a few flags.  Everything else about a
+ * card (its name, suit, value and colour) is looked up by id in one shared table.
+ * Mouse presses are not delivered to cards at all: the scene finds the card under the
+ * pointer and reports clicks, double clicks and drags as its own signals, see myScene.
+ */
+class Card : public QGraphicsItem
 {
-    Q_OBJECT
     Q_DISABLE_COPY(Card)
 public:
+    enum { Type = UserType + 1 };      ///< For qgraphicsitem_cast
 
     Card() = delete;
     Card(CardValue v, Suit s, QGraphicsItem *parent = nullptr);
     ~Card();
 
+    int type() const override { return Type; }
+
     bool isFaceUp() const { return mFaceUp; }
     void setFaceUp(bool faceUp);
 
-    Suit getSuit() const { return mSuit; }
-    QColor getColor() const { return mColor; }
-    CardValue getValue() const { return mValue; }
-    const QString& getText() const { return mPaintText; }
+    CardId cardId() const { return mId; }
+    Suit getSuit() const { return cardSuit(mId); }
+    QColor getColor() const { return isRedCard(mId) ? Qt::red : Qt::black; }
+    CardValue getValue() const { return cardValue(mId); }
+    const QString& getText() const { return cardName(mId); }
+
+    static QString cardText(CardId id);
+    static const QString& cardName(CardId id);
 
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
-signals:
-    void clicked(Card& card);
-    void doubleClicked(Card& card);
-
 protected:
     void hoverEnterEvent(QGraphicsSceneHoverEvent *event) override;
     void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
 
-    void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
-    void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
-    void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
-    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) override;
-
-
  private:
-    QChar getSuitChar();
-    const char *getValueText();
-    const char *getImagePath();
+    static QChar suitChar(Suit suit);
+    static const char *valueText(CardValue value);
 
+    CardId mId;
     bool mFaceUp;             ///< True if card face is showing, otherwise back of card is visible
-    bool mMouseDown;
     bool mHover;
-    QColor mColor;
-    QString mPaintText;
-    QGraphicsSvgItem *mImage;           // Note: these are deleted via being children of the card ;)
-    QGraphicsSvgItem *mBackImage;       //       Refer to https://doc.qt.io/qt-6/objecttrees.html if
-                                              //       you are unfamiliar with qt memory management
-
-    CardValue mValue;
-    Suit mSuit;
 };
 
-QDataStream & operator << (QDataStream & s, const Card *cardptr);
-QDataStream & operator >> (QDataStream & s, Card *& cardptr);
-
 #endif // CARD_H
@@ -0,0 +1,176 @@
+#include "cardanimator.h"
+#include "trace.h"
+
+#include <QCoreApplication>
+#include <QGraphicsItem>
+
+#include <algorithm>
+
+CardAnimator::CardAnimator(QObject *parent)
+    : QAbstractAnimation(parent)
+{
+    mTracks.reserve(64);
+}
+
+CardAnimator* CardAnimator::instance()
+{
+    static CardAnimator *animator = new CardAnimator(QCoreApplication::instance());
+    return animator;
+}
+
+/**
+ * @brief moveTo - animate item from where it is now to end (in its parent's coordinates)
+ *
+ * @param item item to move
+ * @param end final position
+ * @param durationMs length of the move
+ * @param easing curve applied to the move
+ * @param delayMs time to wait, from now, before the item starts moving
+ */
+void CardAnimator::moveTo(QGraphicsItem *item, const QPointF& end, int durationMs,
+                          QEasingCurve::Type easing, int delayMs)
+{
+    if (!item) {
+        return;
+    }
+    cancel(item);
+
+    const bool running = (state() == QAbstractAnimation::Running);
+    const int now = running ? currentTime() : 0;
+    mTracks.push_back(Track{item, item->pos(), end, now + delayMs, durationMs, curveIndex(easing)});
+    if (!running) {
+        start();
+    }
+}
+
+/**
+ * @brief queueMove - like moveTo, but start delayMs after the item's last queued move ends
+ *
+ * Without moves queued for item this is the same as moveTo.
+ */
+void CardAnimator::queueMove(QGraphicsItem *item, const QPointF& end, int durationMs,
+                             QEasingCurve::Type easing, int delayMs)
+{
+    const Track *last{nullptr};
+    for (const Track& track : mTracks) {
+        if (track.item == item && (!last || track.begin > last->begin)) {
+            last = &track;
+        }
+    }
+    if (!last) {
+        moveTo(item, end, durationMs, easing, delayMs);
+        return;
+    }
+    const int begin = last->begin + last->duration + delayMs;
+    const QPointF start = last->end;
+    mTracks.push_back(Track{item, start, end, begin, durationMs, curveIndex(easing)});
+}
+
+/**
+ * @brief cancel - stop moving item, leaving it wherever it is
+ */
+void CardAnimator::cancel(QGraphicsItem *item)
+{
+    mTracks.erase(std::remove_if(mTracks.begin(), mTracks.end(),
+                                 [item](const Track& track) { return track.item == item; }),
+                  mTracks.end());
+}
+
+/**
+ * @brief finishAll - jump every moving item to its end position now
+ */
+void CardAnimator::finishAll()
+{
+    // The last leg of each item's path is applied last
+    std::stable_sort(mTracks.begin(), mTracks.end(),
+                     [](const Track& a, const Track& b) { return a.begin < b.begin; });
+    for (const Track& track : mTracks) {
+        track.item->setPos(track.end);
+    }
+    mTracks.clear();
+    if (state() != QAbstractAnimation::Stopped) {
+        stop();
+    }
+    runCallbacks();
+}
+
+/**
+ * @brief whenFinished - run callback once every current and future move has finished
+ *
+ * The callback is dropped if context is destroyed first.  If nothing is moving it
+ * runs right away.
+ */
+void CardAnimator::whenFinished(QObject *context, std::function<void()> callback)
+{
+    mCallbacks.push_back(Callback{context, std::move(callback)});
+    if (mTracks.empty()) {
+        runCallbacks();
+    }
+}
+
+bool CardAnimator::isAnimating(QGraphicsItem *item) const
+{
+    for (const Track& track : mTracks) {
+        if (track.item == item) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief updateCurrentTime - advance every track to currentTime in one pass
+ *
+ * An item's legs are kept in the order they were queued, so when one tick passes the
+ * ends of several of them the last leg is applied last.  Finished tracks are removed
+ * after the pass, keeping that order.
+ */
+void CardAnimator::updateCurrentTime(int currentTime)
+{
+    TRACE_SPAN("animation", "CardAnimator::tick");
+    for (const Track& track : mTracks) {
+        if (currentTime < track.begin) {
+            continue;
+        }
+        const int elapsed = currentTime - track.begin;
+        if (elapsed >= track.duration) {
+            track.item->setPos(track.end);
+            continue;
+        }
+        const qreal progress = mCurves[track.curve].valueForProgress(qreal(elapsed) / track.duration);
+        track.item->setPos(track.start + (track.end - track.start) * progress);
+    }
+    mTracks.erase(std::remove_if(mTracks.begin(), mTracks.end(),
+                                 [currentTime](const Track& track) {
+                                     return currentTime - track.begin >= track.duration;
+                                 }),
+                  mTracks.end());
+
+    if (mTracks.empty()) {
+        stop();
+        runCallbacks();
+    }
+}
+
+int CardAnimator::curveIndex(QEasingCurve::Type easing)
+{
+    for (size_t i = 0; i < mCurves.size(); ++i) {
+        if (mCurves[i].type() == easing) {
+            return static_cast<int>(i);
+        }
+    }
+    mCurves.push_back(QEasingCurve(easing));
+    return static_cast<int>(mCurves.size() - 1);
+}
+
+void CardAnimator::runCallbacks()
+{
+    // Callbacks may queue new moves and callbacks, so run a private copy
+    std::vector<Callback> callbacks;
+    callbacks.swap(mCallbacks);
+    for (Callback& callback : callbacks) {
+        if (callback.context) {
+            callback.function();
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef CARDANIMATOR_H
+#define CARDANIMATOR_H
+
+#include <QAbstractAnimation>
+#include <QEasingCurve>
+#include <QPointF>
+#include <QPointer>
+
+#include <functional>
+#include <vector>
+
+QT_FORWARD_DECLARE_CLASS(QGraphicsItem)
+
+/**
+ * @brief The CardAnimator class moves any number of cards on a single animation timer
+ *
+ * Instead of one QPropertyAnimation per card (each with its own timer registration and
+ * a "pos" property dispatch per frame), every move is a plain Track in one contiguous
+ * array, and each tick advances all of them and sets their positions in one pass.
+ * The scene then repaints everything that moved in a single update.
+ *
+ * Moves can be added at any time, also while others are running, and are delayed
+ * relative to the moment they are added.  moveTo() replaces any moves the item already
+ * has, queueMove() starts after the item's last move instead, so one item can follow a
+ * path of several legs on the same timeline.  The animator stops itself when the last
+ * track finishes and then runs the callbacks queued with whenFinished().
+ *
+ * There is one animator for the whole application, see instance().  GUI thread only.
+ */
+class CardAnimator : public QAbstractAnimation
+{
+    Q_OBJECT
+public:
+    static CardAnimator* instance();
+
+    void moveTo(QGraphicsItem *item, const QPointF& end, int durationMs,
+                QEasingCurve::Type easing = QEasingCurve::InOutQuad, int delayMs = 0);
+    void queueMove(QGraphicsItem *item, const QPointF& end, int durationMs,
+                   QEasingCurve::Type easing = QEasingCurve::InOutQuad, int delayMs = 0);
+    void cancel(QGraphicsItem *item);
+    void finishAll();
+    void whenFinished(QObject *context, std::function<void()> callback);
+
+    bool isAnimating(QGraphicsItem *item) const;
+    int trackCount() const { return static_cast<int>(mTracks.size()); }
+
+    int duration() const override { return -1; }   ///< Runs until the last track is done
+
+protected:
+    void updateCurrentTime(int currentTime) override;
+
+private:
+    explicit CardAnimator(QObject *parent = nullptr);
+
+    struct Track {
+        QGraphicsItem *item;
+        QPointF start;
+        QPointF end;
+        int begin;              ///< Animator time the move starts at
+        int duration;
+        int curve;              ///< Index in mCurves
+    };
+    struct Callback {
+        QPointer<QObject> context;
+        std::function<void()> function;
+    };
+
+    int curveIndex(QEasingCurve::Type easing);
+    void runCallbacks();
+
+    std::vector<Track> mTracks;
+    std::vector<QEasingCurve> mCurves;      ///< The few distinct curves in use
+    std::vector<Callback> mCallbacks;
+};
+
+#endif // CARDANIMATOR_H
@@ -0,0 +1,260 @@
+#include "cardatlas.h"
+#include "card.h"
+#include "constants.h"
+#include "svgcache.h"
+
+#include <QCache>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QSvgRenderer>
+#include <QtMath>
+
+#include <deque>
+#include <utility>
+
+static const char BACK_IMAGE[] {":/images/Card-Back.svg"};
+
+/**
+ * @brief imagePath - SVG picture of a card, for the court cards only
+ *
+ * @return resource path, or nullptr if the card is drawn as text
+ */
+const char* CardAtlas::imagePath(CardId id)
+{
+    static const char *const COURT_IMAGES[NUM_SUITS][3] {
+        { ":/images/Jack-Hearts.svg",   ":/images/Queen-Hearts.svg",   ":/images/King-Hearts.svg" },
+        { ":/images/Jack-Diamonds.svg", ":/images/Queen-Diamonds.svg", ":/images/King-Diamonds.svg" },
+        { ":/images/Jack-Spades.svg",   ":/images/Queen-Spades.svg",   ":/images/King-Spades.svg" },
+        { ":/images/Jack-Clubs.svg",    ":/images/Queen-Clubs.svg",    ":/images/King-Clubs.svg" },
+    };
+    int rank = cardRank(id);
+    if (rank < static_cast<int>(CardValue::JACK)) {
+        return nullptr;
+    }
+    return COURT_IMAGES[cardSuitIndex(id)][rank - static_cast<int>(CardValue::JACK)];
+}
+
+QSize CardAtlas::cellSize(qreal dpr)
+{
+    return QSize(qCeil(CARD_WIDTH * dpr), qCeil(CARD_HEIGHT * dpr));
+}
+
+/**
+ * @brief sourceRect - pixel rectangle of one card picture in atlas(dpr)
+ */
+QRect CardAtlas::sourceRect(CardId id, bool faceUp, bool hover, qreal dpr)
+{
+    return cellRect((faceUp ? id : NUM_CARDS) + (hover ? NUM_CARDS + 1 : 0), dpr);
+}
+
+QRect CardAtlas::cellRect(int cell, qreal dpr)
+{
+    QSize size = cellSize(dpr);
+    return QRect((cell % ATLAS_COLUMNS) * size.width(), (cell / ATLAS_COLUMNS) * size.height(),
+                 size.width(), size.height());
+}
+
+QSize CardAtlas::imageSize(qreal dpr)
+{
+    const int rows = (ATLAS_CELLS + ATLAS_COLUMNS - 1) / ATLAS_COLUMNS;
+    return QSize(cellSize(dpr).width() * ATLAS_COLUMNS, cellSize(dpr).height() * rows);
+}
+
+/**
+ * @brief atlas - every card picture for a device pixel ratio, rendered on first use
+ */
+const QPixmap& CardAtlas::atlas(qreal dpr)
+{
+    // A deque, so references handed out stay valid when another ratio is added
+    static std::deque<std::pair<qreal, QPixmap>> atlases;
+    for (const std::pair<qreal, QPixmap>& entry : atlases) {
+        if (qFuzzyCompare(entry.first, dpr)) {
+            return entry.second;
+        }
+    }
+    QImage image = bakedImage(dpr);
+    if (image.isNull()) {
+        image = renderImage(dpr);
+    }
+    atlases.emplace_back(dpr, QPixmap::fromImage(image));
+    return atlases.back().second;
+}
+
+/**
+ * @brief bakedImage - the atlas for dpr from the images baked in at build time
+ *
+ * The resource ":/atlas/cardatlas.txt" lists the baked atlases, one per line:
+ *   scale cellWidth cellHeight columns cells file
+ * A baked scale equal to dpr is used as is; otherwise the smallest larger one is
+ * scaled down cell by cell, so no SVG is parsed.
+ *
+ * @return the atlas, or a null image if dpr is beyond every baked scale (or nothing
+ *         was baked), in which case it has to be rendered from the SVG files
+ */
+QImage CardAtlas::bakedImage(qreal dpr)
+{
+    QFile table(QStringLiteral(":/atlas/cardatlas.txt"));
+    if (!table.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        return QImage();
+    }
+
+    // Pick the best baked atlas that matches the current layout
+    qreal bestScale{0.0};
+    QString bestFile;
+    while (!table.atEnd()) {
+        const QList<QByteArray> fields = table.readLine().simplified().split(' ');
+        if (fields.size() != 6 || fields[0].startsWith('#')) {
+            continue;
+        }
+        const qreal scale = fields[0].toDouble();
+        if (QSize(fields[1].toInt(), fields[2].toInt()) != cellSize(scale) ||
+            fields[3].toInt() != ATLAS_COLUMNS || fields[4].toInt() != ATLAS_CELLS) {
+            continue;
+        }
+        if (scale + 1e-6 >= dpr && (bestFile.isEmpty() || scale < bestScale)) {
+            bestScale = scale;
+            bestFile = QString::fromLatin1(fields[5]);
+        }
+    }
+    if (bestFile.isEmpty()) {
+        return QImage();
+    }
+
+    QImage baked(QStringLiteral(":/atlas/") + bestFile);
+    if (baked.isNull() || qFuzzyCompare(bestScale, dpr)) {
+        return baked;
+    }
+
+    QImage image(imageSize(dpr), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    for (int c = 0; c < ATLAS_CELLS; ++c) {
+        painter.drawImage(cellRect(c, dpr), baked, cellRect(c, bestScale));
+    }
+    return image;
+}
+
+/**
+ * @brief draw one card picture into target, a single drawPixmap() from the atlas
+ */
+void CardAtlas::draw(QPainter *painter, const QRectF& target, CardId id, bool faceUp, bool hover)
+{
+    qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    painter->drawPixmap(target, atlas(dpr), QRectF(sourceRect(id, faceUp, hover, dpr)));
+}
+
+/**
+ * @brief cardPixmap - copy of one card picture, e.g. for a drag image
+ */
+QPixmap CardAtlas::cardPixmap(CardId id, bool faceUp, bool hover, qreal dpr)
+{
+    QPixmap pixmap = atlas(dpr).copy(sourceRect(id, faceUp, hover, dpr));
+    pixmap.setDevicePixelRatio(dpr);
+    return pixmap;
+}
+
+/**
+ * @brief runPixmap - picture of a run of face up cards, as they lie on a tableau column
+ *
+ * The cards overlap by CARD_OVERLAP, first card at the bottom.  Pictures are cached by
+ * their card ids and dpr, so dragging the same run again costs no painting at all.
+ */
+QPixmap CardAtlas::runPixmap(const QVector<CardId>& run, qreal dpr)
+{
+    static QCache<QByteArray, QPixmap> cache(RUN_CACHE_KB);
+
+    QByteArray key(reinterpret_cast<const char*>(&dpr), sizeof(dpr));
+    for (CardId id : run) {
+        key.append(static_cast<char>(id));
+    }
+    if (const QPixmap *cached = cache.object(key)) {
+        return *cached;
+    }
+
+    const QSize cell = cellSize(dpr);
+    const int overlap = qRound(CARD_OVERLAP * dpr);
+    QPixmap pixmap(cell.width(), cell.height() + overlap * qMax(0, int(run.size()) - 1));
+    pixmap.fill(Qt::transparent);
+    QPainter painter(&pixmap);
+    const QPixmap& source = atlas(dpr);
+    for (int i = 0; i < run.size(); ++i) {
+        painter.drawPixmap(QPoint(0, i * overlap), source, sourceRect(run[i], true, false, dpr));
+    }
+    painter.end();
+    pixmap.setDevicePixelRatio(dpr);
+
+    cache.insert(key, new QPixmap(pixmap), qMax(1, pixmap.width() * pixmap.height() * 4 / 1024));
+    return pixmap;
+}
+
+/**
+ * @brief renderImage - draw the atlas for dpr from the SVG files
+ *
+ * Used at run time when nothing suitable was baked, and by solitaire-atlas-baker.
+ */
+QImage CardAtlas::renderImage(qreal dpr)
+{
+    QImage image(imageSize(dpr), QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+
+    QPainter painter(&image);
+    painter.setRenderHints(QPainter::Antialiasing | QPainter::TextAntialiasing | QPainter::SmoothPixmapTransform);
+    for (int c = 0; c < ATLAS_CELLS; ++c) {
+        painter.save();
+        painter.translate(cellRect(c, dpr).topLeft());
+        painter.scale(dpr, dpr);
+        painter.translate(CARD_WIDTH / 2.0, CARD_HEIGHT / 2.0);
+        paintCard(&painter, c);
+        painter.restore();
+    }
+    painter.end();
+
+    return image;
+}
+
+/**
+ * @brief paintCard - draw one atlas cell the way Card::paint and its SVG children used to
+ *
+ * The painter's origin is the center of the card.
+ */
+void CardAtlas::paintCard(QPainter *painter, int cell)
+{
+    const bool hover = cell > NUM_CARDS;
+    const int index = cell % (NUM_CARDS + 1);
+    const bool back = (index == NUM_CARDS);
+    const CardId id = static_cast<CardId>(index);
+
+    // Inset by half the pen, so the whole border fits in the cell
+    const qreal penWidth = hover ? 2.0 : 1.0;
+    const QRectF rect = QRectF(-(CARD_WIDTH/2), -(CARD_HEIGHT/2), CARD_WIDTH, CARD_HEIGHT)
+                            .adjusted(penWidth/2, penWidth/2, -penWidth/2, -penWidth/2);
+
+    // Draw Drop shadow
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(Qt::darkGray);
+    painter->drawRoundedRect(rect, CARD_RADIUS, CARD_RADIUS);
+
+    // Draw square
+    painter->setPen(QPen(Qt::black, penWidth));
+    painter->setBrush(QBrush(Qt::white));
+    painter->drawRoundedRect(rect, CARD_RADIUS, CARD_RADIUS);
+
+    const char *path = back ? BACK_IMAGE : imagePath(id);
+    if (path) {
+        // Same placement as the QGraphicsSvgItem children cards used to have: scaled by
+        // SVG_SCALEF about the point (-CARD_WIDTH/2, -3-CARD_HEIGHT/2)
+        QSvgRenderer *renderer = SvgCache::renderer(path);
+        painter->save();
+        painter->translate(QPointF(-(CARD_WIDTH/2), -3-(CARD_HEIGHT/2)) * (1.0 - SVG_SCALEF));
+        painter->scale(SVG_SCALEF, SVG_SCALEF);
+        renderer->render(painter, QRectF(QPointF(0, 0), renderer->defaultSize()));
+        painter->restore();
+    } else {
+        // And the text
+        painter->setPen(isRedCard(id) ? Qt::red : Qt::black);
+        painter->drawText(QPoint{-(CARD_WIDTH/2)+SHDW+1, -(CARD_WIDTH/2)+SHDW+1}, Card::cardText(id));
+    }
+}
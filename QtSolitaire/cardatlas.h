@@ -0,0 +1,54 @@
+#ifndef CARDATLAS_H
+#define CARDATLAS_H
+
+#include "cardtypes.h"
+
+#include <QImage>
+#include <QPixmap>
+#include <QRect>
+#include <QVector>
+
+QT_FORWARD_DECLARE_CLASS(QPainter)
+
+/**
+ * @brief The CardAtlas class holds every card picture, pre-rendered into one pixmap
+ *
+ * The atlas has a cell for each of the 52 faces and the back, each in a normal and a
+ * hover (thick border) variant, rendered once per device pixel ratio the first time a
+ * card is painted on a screen with that ratio.  Painting a card is then a single
+ * drawPixmap() from the atlas instead of rounded rectangles, text and an SVG render.
+ *
+ * Cells are laid out ATLAS_COLUMNS wide in the order: faces by CardId, back, hover faces
+ * by CardId, hover back.  Only use from the GUI thread.
+ *
+ * Atlases for a few standard ratios are baked at build time by solitaire-atlas-baker
+ * and embedded as resources under ":/atlas/".  The SVG files are only parsed when the
+ * ratio is larger than any of those.
+ */
+class CardAtlas
+{
+public:
+    CardAtlas() = delete;
+
+    static void draw(QPainter *painter, const QRectF& target, CardId id, bool faceUp, bool hover);
+    static QPixmap cardPixmap(CardId id, bool faceUp, bool hover, qreal dpr);
+    static QPixmap runPixmap(const QVector<CardId>& run, qreal dpr);
+
+    static const QPixmap& atlas(qreal dpr);
+    static QRect sourceRect(CardId id, bool faceUp, bool hover, qreal dpr);
+    static const char* imagePath(CardId id);
+    static QImage renderImage(qreal dpr);
+    static QSize cellSize(qreal dpr);
+
+    static const int ATLAS_COLUMNS{14};
+    static const int ATLAS_CELLS{2*(NUM_CARDS + 1)};
+    static const int RUN_CACHE_KB{8*1024};     ///< Size of the runPixmap() cache
+
+private:
+    static QRect cellRect(int cell, qreal dpr);
+    static QSize imageSize(qreal dpr);
+    static QImage bakedImage(qreal dpr);
+    static void paintCard(QPainter *painter, int cell);
+};
+
+#endif // CARDATLAS_H
@@ -1,16 +1,20 @@
 #include "cardstack.h"
+#include "cardanimator.h"
+#include "cardatlas.h"
 #include "constants.h"
-#include "undocommands.h"
+#include "logging.h"
+#include "renderstats.h"
+#include "rules.h"
+#include "scenetransaction.h"
+#include "svgcache.h"
+#include "tablelayout.h"
+#include "trace.h"
 
 #include <QPainter>
 #include <QCursor>
 #include <QDebug>
-#include <QGraphicsSceneDragDropEvent>
+#include <QGraphicsSceneHoverEvent>
 #include <QGraphicsSvgItem>
-#include <QIoDevice>
-#include <QMimeData>
-#include <QPropertyAnimation>
-#include <QParallelAnimationGroup>
 
 const int FAN_DURATION_MS{750};             ///< Time in ms for Card Fanning animation to run
 
@@ -57,29 +61,28 @@ CardStack::CardStack(QGraphicsItem *parent, QUndoStack *undoStack)
     ,mColor{Qt::lightGray}
     ,mDragOver{false}
     ,mMouseDown{false}
-    ,mTopFlipped{false}
+    ,mLifted{0}
+    ,mPile{NUM_PILES}
+    ,mModel{nullptr}
+    ,mCardItems{nullptr}
     ,mUndoStack{undoStack, &QObject::deleteLater}
     ,mCards{}
 {
     setToolTip(QString("Drop Matching Cards Here\n"));
 
     setAcceptedMouseButtons(Qt::LeftButton);
-    setAcceptDrops(true);
 
-    if (debugLevel >= DEBUG_LEVEL::VERBOSE) {
-        qDebug() << "Created CardStack" << this;
-    }
+    qCDebug(lcStack) << "Created CardStack" << this;
 }
 
 CardStack::~CardStack() {
 
-    if (debugLevel >= DEBUG_LEVEL::VERBOSE) {
-        qDebug() << "Destroyed CardStack" << this;
-    }
+    qCDebug(lcStack) << "Destroyed CardStack" << this;
 }
 
 void CardStack::addCard(Card *card, bool flipTop)
 {
+    TRACE_SPAN("scene", "CardStack::addCard");
     if (card) {
         if (!mCards.empty() && flipTop) {
             mCards.back()->setFaceUp(!mCards.back()->isFaceUp());
@@ -89,9 +92,84 @@ void CardStack::addCard(Card *card, bool flipTop)
     }
 }
 
+/**
+ * @brief attachModel - make this stack mirror one pile of the game model
+ *
+ * @param model the game model
+ * @param cardItems scene items indexed by CardId
+ * @param pile pile this stack shows
+ */
+void CardStack::attachModel(GameState *model, Card *const cardItems[], Pile pile)
+{
+    mModel = model;
+    mCardItems = cardItems;
+    mPile = pile;
+}
+
+/**
+ * @brief syncFromModel - make this stack show exactly the cards of its pile in the model
+ *
+ * The card items are placed through the current SceneTransaction, or a transaction of
+ * our own if none is open, so syncing several stacks moves each card only once.
+ */
+void CardStack::syncFromModel()
+{
+    TRACE_SPAN("scene", "CardStack::syncFromModel");
+    if (!mModel || mPile >= NUM_PILES) {
+        return;
+    }
+    SceneTransaction transaction(scene());
+    prepareGeometryChange();
+    mCards.clear();
+    int count = mModel->pileSize(mPile);
+    for (int i = 0; i < count; ++i) {
+        CardId id = mModel->cardAt(mPile, i);
+        Card *card = mCardItems[id];
+        CardAnimator::instance()->cancel(card);
+        transaction.place(card, this, cardPos(i), i, mModel->isFaceUp(id));
+        mCards.push_back(card);
+    }
+    transaction.touch(this);
+}
+
+/**
+ * @brief cardPos - location of the card at index (0 = bottom) in stack coordinates
+ */
+QPointF CardStack::cardPos(int index) const
+{
+    Q_UNUSED(index);
+    return QPointF(0, 0);
+}
+
+/**
+ * @brief cardAt - the card at pos (stack coordinates) when this stack paints its own cards
+ */
+Card* CardStack::cardAt(const QPointF& pos) const
+{
+    Q_UNUSED(pos);
+    return nullptr;
+}
+
+/**
+ * @brief canAdd - ask the rules engine whether card may be dropped on this stack's pile
+ */
+bool CardStack::canAdd(Card& card) const
+{
+    if (!mModel || mPile >= NUM_PILES) {
+        return false;
+    }
+    return canAddCard(*mModel, mPile, card.cardId());
+}
+
+/**
+ * @brief canTake - true if card is the face up top card of this stack's pile
+ */
 bool CardStack::canTake(Card& card) const
 {
-    return ((mCards.size() > 0) && (&card == mCards.back()));
+    if (!mModel || mPile >= NUM_PILES) {
+        return false;
+    }
+    return canTakeCard(*mModel, mPile, card.cardId());
 }
 
 Card *CardStack::takeCard(Card *card) {
@@ -106,6 +184,7 @@ Card *CardStack::takeCard(Card *card) {
 
 Card* CardStack::takeTop()
 {
+    TRACE_SPAN("scene", "CardStack::takeTop");
     Card *card = {nullptr};
     if (!mCards.isEmpty()) {
         card = mCards.takeLast();
@@ -164,29 +243,28 @@ void CardStack::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
 
 }
 
-void CardStack::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
+/**
+ * @brief setDragOver - highlight the stack as the target of the card being dragged
+ */
+void CardStack::setDragOver(bool dragOver)
 {
-    if (event->mimeData()->hasColor()) {
-        event->setAccepted(true);
-        mDragOver = true;
+    if (dragOver != mDragOver) {
+        mDragOver = dragOver;
         update();
-    } else {
-        event->setAccepted(false);
     }
 }
 
-void CardStack::dragLeaveEvent(QGraphicsSceneDragDropEvent *event)
-{
-    Q_UNUSED(event);
-    mDragOver = false;
-    update();
-}
-void CardStack::dropEvent(QGraphicsSceneDragDropEvent *event)
+/**
+ * @brief setLifted - leave the top count cards out, while a drag shows them elsewhere
+ */
+void CardStack::setLifted(int count)
 {
-    mDragOver = false;
-    if (event->mimeData()->hasColor())
-        mColor = qvariant_cast<QColor>(event->mimeData()->colorData());
-    update();
+    if (count != mLifted) {
+        mLifted = count;
+        if (paintsCards()) {
+            update();
+        }
+    }
 }
 
 /******************************************************************************
@@ -195,10 +273,13 @@ void CardStack::dropEvent(QGraphicsSceneDragDropEvent *event)
 SortedStack::SortedStack(Suit s, QGraphicsItem *parent, QUndoStack *undoStack)
     : CardStack(parent, undoStack)
     , mSuit{s}
+    , mImage{nullptr}
 {
     const char *imgPath = getImagePath(s);
     if (imgPath != nullptr) {
-        mImage = new QGraphicsSvgItem(imgPath, this);
+        // Parsed once through the SvgCache, like every other picture
+        mImage = new QGraphicsSvgItem(this);
+        mImage->setSharedRenderer(SvgCache::renderer(imgPath));
         mImage->setScale(0.2);
         mImage->setOpacity(0.4);
         mImage->setPos(-CARD_WIDTH/4.0, -CARD_HEIGHT/4.0);
@@ -218,15 +299,6 @@ void SortedStack::newGame()
     }
 }
 
-bool SortedStack::canAdd(Card& card) const
-{
-    // TODO: ugly casting to get next value of class enum!
-    CardValue testValue = mCards.size() == 0 ? CardValue::ACE : static_cast<CardValue>((int)mCards.back()->getValue() +1);
-    
-    return ((mSuit == card.getSuit()) &&
-            (testValue == card.getValue()));
-}
-
 void SortedStack::addCard(Card *card, bool flipTop)
 {
     if (card) {
@@ -237,31 +309,21 @@ void SortedStack::addCard(Card *card, bool flipTop)
 
 void SortedStack::fanCards(FanDirection dir)
 {
-    QSizeF newLocation{0.0, 0.0};
-    QPropertyAnimation* a;
-    QParallelAnimationGroup aGroup;
-
+    Q_UNUSED(dir);
+    CardAnimator *animator = CardAnimator::instance();
     int i {0};
     int numCards = mCards.size()+1;
 
     for (auto it : mCards) {
-        a = new QPropertyAnimation(it, "pos");
-        a->setDuration(FAN_DURATION_MS);
-        a->setEasingCurve(QEasingCurve::InOutBack);
-        a->setStartValue(it->pos());
-        a->setEndValue(getFanLocation(i, numCards, FanDirection::HORIZONTAL, QRect(100,20, 700,80)));
-        aGroup.addAnimation(a);
+        animator->moveTo(it, getFanLocation(i, numCards, FanDirection::HORIZONTAL, QRect(100,20, 700,80)),
+                         FAN_DURATION_MS, QEasingCurve::InOutBack);
         i++;
     }
-
-    QObject::connect(&aGroup, &QAbstractAnimation::finished, this, &SortedStack::fanAnimationFinished);
-    aGroup.start(QAbstractAnimation::DeleteWhenStopped);
-
+    animator->whenFinished(this, [this]() { fanAnimationFinished(); });
 }
 
 void SortedStack::fanAnimationFinished() {
 
-    int i = 0;
     Card *prevCard = nullptr;
 
     for (auto it : mCards) {
@@ -277,6 +339,7 @@ void SortedStack::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
 {
     Q_UNUSED(option);
     Q_UNUSED(widget);
+    RenderStats::countPaint();
     painter->save();
     if (mDragOver) {
         painter->setPen(Qt::black);
@@ -292,43 +355,6 @@ void SortedStack::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
     painter->restore();
 }
 
-void SortedStack::dropEvent(QGraphicsSceneDragDropEvent *event)
-{
-    Card *droppedCard{nullptr};
-
-    mDragOver = false;
-
-    if(event->mimeData()->hasFormat(CARD_MIME_TYPE)) {
-        QByteArray itemData = event->mimeData()->data("application/x-card");
-        QDataStream dataStream(&itemData, QIODevice::ReadOnly);
-
-        dataStream >> droppedCard;
-        if (!droppedCard) {
-            event->setAccepted(false);
-            return;
-        }
-
-        if (canAdd(*droppedCard)) {
-            QGraphicsItem *otherStack = droppedCard->parentItem();
-            DescendingStack *dStack = dynamic_cast<DescendingStack*>(otherStack);
-            if (dStack) {
-                PlayfieldToFoundationCommand *command = new PlayfieldToFoundationCommand(dStack, this);
-                mUndoStack->push(command);
-            }
-
-            RandomStack *rStack = dynamic_cast<RandomStack*>(otherStack);
-            if (rStack) {
-                WasteToFoundationCommand *command = new WasteToFoundationCommand(rStack, this);
-                mUndoStack->push(command);
-            }
-            event->setAccepted(true);
-            update();
-        }
-    } else {
-        event->setAccepted(false);
-    }
-}
-
 const char *SortedStack::getImagePath(Suit s)
 {
     switch(s) {
@@ -346,6 +372,8 @@ const char *SortedStack::getImagePath(Suit s)
  *****************************************************************************/
 DescendingStack::DescendingStack(QGraphicsItem *parent, QUndoStack *undoStack)
     : CardStack(parent, undoStack)
+    , mColumnMode{false}
+    , mHoverIndex{-1}
 {
 
 }
@@ -359,24 +387,6 @@ void DescendingStack::newGame()
 {
 }
 
-bool DescendingStack::canAdd(Card& card) const
-{
-    CardValue testValue = CardValue::KING;      // Empty stack will allow you to drop a king
-    QColor testColor = Qt::white;               // Use a non-valid color to allow drops when empty
-
-    // TODO: ugly casting to get next value of class enum!
-    if (!mCards.isEmpty()) {
-            if (mCards.back()->getValue() == CardValue::ACE) {
-                return false;
-            } else {
-                testValue = static_cast<CardValue>((int)mCards.back()->getValue() - 1);
-                testColor = mCards.back()->getColor();
-            }
-    }
-    return ((testValue == card.getValue()) &&
-            (testColor != card.getColor()));
-}
-
 void DescendingStack::addCard(Card* card, bool flipTop)
 {
     if (card) {
@@ -384,50 +394,6 @@ void DescendingStack::addCard(Card* card, bool flipTop)
             card->setPos(0, getYOffset());
     }
 }
-/**
- * @brief DescendingStack::takeTop
- *
- * Descending Stack is different from the others because it may or may not
- * need to flip over the next card.  This is important for the undo commands.
- *
- *  @return top card from the stack or null if stack is empty.
- */
-Card* DescendingStack::takeTop()
-{
-    Card *card = CardStack::takeTop();
-
-    if (card && !mCards.isEmpty() && !mCards.back()->isFaceUp()) {
-        mCards.back()->setFaceUp(true);
-        mTopFlipped = true;
-    } else {
-        mTopFlipped = false;
-    }
-    return card;
-}
-
-QList<Card*> DescendingStack::takeCards(Card& card)
-{
-    int startIndex{0},  moveCount{0};
-    QList<Card*> result;
-    if (mCards.empty()) {
-            return result;
-    }
-    startIndex = mCards.indexOf(&card);
-    if (startIndex == -1) {
-            return result;
-    }
-    moveCount = mCards.size()-startIndex;
-    result = mCards.mid(startIndex, moveCount);
-    mCards.remove(startIndex, moveCount);
-    if (!mCards.empty() && !mCards.back()->isFaceUp()) {
-        mCards.back()->setFaceUp(true);
-         mTopFlipped = true;
-    } else {
-         mTopFlipped = false;
-    }
-    return result;
-}
-
 QRectF DescendingStack::boundingRect() const
 {
     double yAddress = getYOffset();
@@ -440,6 +406,8 @@ void DescendingStack::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
 {
     Q_UNUSED(option);
     Q_UNUSED(widget);
+    TRACE_SPAN("paint", "DescendingStack::paint");
+    RenderStats::countPaint();
     painter->save();
     if (mDragOver) {
         painter->setPen(Qt::black);
@@ -451,53 +419,72 @@ void DescendingStack::paint(QPainter *painter, const QStyleOptionGraphicsItem *o
     painter->setBrush(Qt::NoBrush);
     painter->drawRoundedRect(boundingRect(), CARD_RADIUS, CARD_RADIUS);
     painter->restore();
+
+    if (mColumnMode) {
+        const int shown = mCards.size() - mLifted;
+        for (int i = 0; i < shown; ++i) {
+            const Card *card = mCards[i];
+            if (!card->isVisible()) {
+                CardAtlas::draw(painter, card->boundingRect().translated(cardPos(i)),
+                                card->cardId(), card->isFaceUp(), i == mHoverIndex);
+            }
+        }
+    }
 }
 
-void DescendingStack::dropEvent(QGraphicsSceneDragDropEvent *event)
+/**
+ * @brief setColumnMode - paint the whole column in this item, or leave it to the card items
+ */
+void DescendingStack::setColumnMode(bool columnMode)
 {
-    Card *droppedCard{nullptr};
-    Card *card{nullptr};
-    double yAddress{0.0};
-
-    mDragOver = false;
+    if (columnMode == mColumnMode) {
+        return;
+    }
+    mColumnMode = columnMode;
+    mHoverIndex = -1;
+    setCacheMode(columnMode ? QGraphicsItem::DeviceCoordinateCache : QGraphicsItem::NoCache);
+    setAcceptHoverEvents(columnMode);
 
-    if(event->mimeData()->hasFormat(CARD_MIME_TYPE)) {
-        QByteArray itemData = event->mimeData()->data("application/x-card");
-        QDataStream dataStream(&itemData, QIODevice::ReadOnly);
-        dataStream >> droppedCard;
-        if (!droppedCard) {
-                event->setAccepted(false);
-                return;
-        }
-        if (canAdd(*droppedCard))  {
-            QGraphicsItem *otherStack = droppedCard->parentItem();
+    // Hides or shows the card items to match
+    syncFromModel();
+    update();
+}
 
-            DescendingStack *dStack = dynamic_cast<DescendingStack*>(otherStack);
-            if (dStack) {
-                DragPlayfieldToPlayfieldCommand * command = new DragPlayfieldToPlayfieldCommand(droppedCard, dStack, this);
-                mUndoStack->push(command);
-            }
+/**
+ * @brief cardAt - the card shown at pos (stack coordinates), found through the TableLayout
+ */
+Card* DescendingStack::cardAt(const QPointF& pos) const
+{
+    if (!mColumnMode || !mModel) {
+        return nullptr;
+    }
+    const int index = TableLayout::cardIndexAt(mapToScene(pos), mPile, *mModel);
+    if (index < 0 || index >= mCards.size() - mLifted || mCards[index]->isVisible()) {
+        return nullptr;
+    }
+    return mCards[index];
+}
 
-            RandomStack *rStack = dynamic_cast<RandomStack*>(otherStack);
-            if (rStack) {
-                DragWasteToPlayfieldCommand *command = new DragWasteToPlayfieldCommand(rStack, this);
-                mUndoStack->push(command);
-            }
+void DescendingStack::setHoverIndex(int index)
+{
+    if (index != mHoverIndex) {
+        mHoverIndex = index;
+        update();
+    }
+}
 
-            SortedStack *sStack = dynamic_cast<SortedStack*>(otherStack);
-            if (sStack) {
-                DragFoundationToPlayfieldCommand *command = new DragFoundationToPlayfieldCommand(sStack, this);
-                mUndoStack->push(command);
-            }
-            update();
-        } else {
-            event->setAccepted(false);
-        }
-    } else {
-            event->setAccepted(false);
-        }
+void DescendingStack::hoverMoveEvent(QGraphicsSceneHoverEvent *event)
+{
+    Card *card = cardAt(event->pos());
+    setHoverIndex(card ? mCards.indexOf(card) : -1);
+    CardStack::hoverMoveEvent(event);
 }
 
+void DescendingStack::hoverLeaveEvent(QGraphicsSceneHoverEvent *event)
+{
+    setHoverIndex(-1);
+    CardStack::hoverLeaveEvent(event);
+}
 
 double DescendingStack::getYOffset() const
 {
@@ -508,33 +495,30 @@ double DescendingStack::getYOffset() const
         return yAddress;
 }
 
-void DescendingStack::fanCards(FanDirection dir)
+QPointF DescendingStack::cardPos(int index) const
 {
-        QSizeF newLocation{0.0, 0.0};
-        QPropertyAnimation* a;
-        QParallelAnimationGroup aGroup;
+        return QPointF(0, (double)index*CARD_OVERLAP);
+}
 
+void DescendingStack::fanCards(FanDirection dir)
+{
+        Q_UNUSED(dir);
+        CardAnimator *animator = CardAnimator::instance();
         int i {0};
         int numCards = mCards.size()+1;
 
         for (auto it : mCards) {
-            a = new QPropertyAnimation(it, "pos");
-            a->setDuration(FAN_DURATION_MS);
-            a->setEasingCurve(QEasingCurve::InOutBack);
-            a->setStartValue(it->pos());
-            a->setEndValue(getFanLocation(i, numCards, FanDirection::HORIZONTAL, QRect(100,20, 700,80)));
-            aGroup.addAnimation(a);
+            it->setVisible(true);
+            animator->moveTo(it, getFanLocation(i, numCards, FanDirection::HORIZONTAL, QRect(100,20, 700,80)),
+                             FAN_DURATION_MS, QEasingCurve::InOutBack);
             i++;
         }
-
-        QObject::connect(&aGroup, &QAbstractAnimation::finished, this, &DescendingStack::fanAnimationFinished);
-        aGroup.start(QAbstractAnimation::DeleteWhenStopped);
-
+        animator->whenFinished(this, [this]() { fanAnimationFinished(); });
+        update();
 }
 
 void DescendingStack::fanAnimationFinished() {
 
-        int i = 0;
         Card *prevCard = nullptr;
 
         for (auto it : mCards) {
@@ -547,16 +531,6 @@ void DescendingStack::fanAnimationFinished() {
 }
 
 
-void DescendingStack::onUpdateState(QAbstractAnimation::State newState, QAbstractAnimation::State oldState)
-{
-        qDebug() << "New State:" << newState;
-        if (oldState == QAbstractAnimation::Running && newState == QAbstractAnimation::Stopped) {
-            this->fanAnimationFinished();
-        }
-}
-
-
-
 /******************************************************************************
  * RandomStack Implementation
  *****************************************************************************/
@@ -574,91 +548,31 @@ void RandomStack::newGame()
 {
 }
 
-bool RandomStack::canAdd(Card& card) const
-{
-    return false;
-}
-
-//TODO: QParallelAnimationGroup is not working!  WTH!
-static bool useGroup = false;
-
 void RandomStack::fanCards(FanDirection dir)
 {
-    QPropertyAnimation* a;
-    QParallelAnimationGroup aGroup{this};
-    QSizeF newLocation{0.0, 0.0};
+    CardAnimator *animator = CardAnimator::instance();
     int i {0};
     int numCards = mCards.size()+1;
 
     for (auto it : mCards) {
-        a = new QPropertyAnimation(it, "pos");
-        a->setDuration(FAN_DURATION_MS);
-        a->setEasingCurve(QEasingCurve::InOutBack);
-        a->setStartValue(it->pos());
-        a->setEndValue(getFanLocation(i, numCards, dir, QRect(20,20, 600,80)));
-        if (useGroup)
-            aGroup.addAnimation(a);
-        else
-            a->start();
-
+        animator->moveTo(it, getFanLocation(i, numCards, dir, QRect(20,20, 600,80)),
+                         FAN_DURATION_MS, QEasingCurve::InOutBack);
         i++;
     }
-
-    // BUG: ?? Connect succeeds for the finished slot, but the slot is not called, had to workaround using statechange.
-    //      Possible OSX only problem? Check on windows
-    //bool result = QObject::connect(&aGroup, &QAbstractAnimation::finished, this, &RandomStack::fanAnimationFinished);
-
-    bool result2 = QObject::connect(&aGroup, &QAbstractAnimation::stateChanged, this, &RandomStack::onUpdateState);
-    qDebug() << "Animation" ""<< (useGroup ?  "Group" : "noGroup") << "Connected:" << result2 << "Duration: " << aGroup.duration();
-    if (useGroup)
-        aGroup.start(QAbstractAnimation::DeleteWhenStopped);
-}
-
-void RandomStack::onUpdateState(QAbstractAnimation::State newState, QAbstractAnimation::State oldState)
-{
-    qDebug() << "New State:" << newState;
-    if (oldState == QAbstractAnimation::Running && newState == QAbstractAnimation::Stopped) {
-        this->fanAnimationFinished();
-    }
+    animator->whenFinished(this, [this]() { fanAnimationFinished(); });
 }
 
 /**
- * @brief RandomStack::fanAnimationFinished - Attempt to reorder the cards after shuffling
- *
- * The fan animation lays out the cards based on their position in the deck.
- * After shuffling the deck, the cards are currently not stacked in order,
- * so the appearance is odd. This is an attempt to get them to stack in order,
- * but is not currently working.
+ * @brief RandomStack::fanAnimationFinished - restack the cards in deck order after shuffling
  *
- * Algorithm variable tries a bunch of different stuff to make it happen. No dice.
+ * Shuffling reorders mCards but not the card items, which are still painted in the order
+ * they were added, so the fanned out cards overlap oddly.  Move every card just below the
+ * card after it, from the top down, so later cards in the deck are painted on top.
  */
-
-static int algorithm = 0;
-
 void RandomStack::fanAnimationFinished() {
 
-    Card *prevCard = nullptr;
-    int i = 0;
-
-    for (auto it : mCards) {
-        if (prevCard) {
-            if (algorithm % 3 == 0) {
-                it->setPos(it->pos());
-            } else if (algorithm % 3 == 1) {
-                it->setZValue(i);
-            } else if (algorithm % 3 == 2) {
-                it->stackBefore(prevCard);
-            }
-            i++;
-            it->hide();
-            it->update();
-        }
-        prevCard = it;
-    }
-    qDebug() << "Fanned cards using algorithm " << algorithm++;
-
-    for (auto it: mCards) {
-        it->show();
+    for (int i = mCards.size() - 2; i >= 0; --i) {
+        mCards[i]->stackBefore(mCards[i+1]);
     }
     update();
 }
@@ -667,6 +581,7 @@ void RandomStack::paint(QPainter *painter, const QStyleOptionGraphicsItem *optio
 {
     Q_UNUSED(option);
     Q_UNUSED(widget);
+    RenderStats::countPaint();
     painter->save();
     if (mDragOver) {
         painter->setPen(Qt::black);
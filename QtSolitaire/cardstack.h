@@ -2,8 +2,8 @@
 #define CARDSTACK_H
 
 #include "card.h"
+#include "gamestate.h"
 
-#include <QAbstractAnimation>
 #include <QObject>
 #include <QGraphicsItem>
 #include <QSharedPointer>
@@ -33,22 +33,35 @@ public:
 
     virtual void newGame() = 0;
 
-    virtual bool canAdd(Card& card) const = 0;
+    virtual bool canAdd(Card& card) const;
     virtual void addCard(Card *card, bool flipTop);
 
     bool canTake(Card& card) const;
     virtual Card* takeCard(Card *card);
     virtual Card* takeTop();
 
-    /* topFlipped property helps with undo - when a card is removed from a stack the topFlipped variable may be set.
-     *  when this property is set and an undo command is executed, then we know to flip it back.
-     *
-     *  This property is valid to read only immediately after a card is removed from the stack.
-     */
-    virtual bool isTopFlipped() const { return mTopFlipped; }
-    virtual void setTopFlipped(bool flipped) { mTopFlipped = flipped;}
-
     bool isEmpty() { return mCards.isEmpty(); }
+    const QList<Card*>& cards() const { return mCards; }
+
+    /* Each stack on the table mirrors one pile of the Game's GameState, and canAdd/canTake
+     * ask the rules engine about that pile.  Stacks that are not part of a dealt game (the
+     * Deck) keep the default of NUM_PILES and accept nothing.
+     */
+    Pile pile() const { return mPile; }
+    GameState* model() const { return mModel; }
+    Card* cardItem(CardId id) const { return mCardItems ? mCardItems[id] : nullptr; }
+    void attachModel(GameState *model, Card *const cardItems[], Pile pile);
+    void syncFromModel();
+    virtual QPointF cardPos(int index) const;
+    void setDragOver(bool dragOver);
+    void setLifted(int count);
+
+    /* A stack that paints its own cards keeps their items hidden, and finds the card
+     * under a point itself.  Card items that are shown (e.g. while they are animated)
+     * paint themselves and are left out.
+     */
+    virtual bool paintsCards() const { return false; }
+    virtual Card* cardAt(const QPointF& pos) const;
 
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
@@ -64,14 +77,14 @@ protected:
     void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
     void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
 
-    void dragEnterEvent(QGraphicsSceneDragDropEvent *event) override;
-    void dragLeaveEvent(QGraphicsSceneDragDropEvent *event) override;
-    void dropEvent(QGraphicsSceneDragDropEvent *event) override;
 
     QColor mColor;
     bool mDragOver;
     bool mMouseDown;
-    bool mTopFlipped;
+    int mLifted;                        ///< Number of top cards picked up by a drag
+    Pile mPile;
+    GameState *mModel;
+    Card *const *mCardItems;            ///< Scene item for each CardId, owned by the Game
     QSharedPointer <QUndoStack>mUndoStack;
     QList<Card*> mCards;
 };
@@ -97,14 +110,11 @@ public:
 
     virtual void newGame() override;
 
-    virtual bool canAdd(Card& card) const override;
     virtual void addCard(Card *card, bool flipTop) override;
 
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
 protected:
-    void dropEvent(QGraphicsSceneDragDropEvent *event) override;
-
     virtual void fanCards(FanDirection dir) override;
 
 protected slots:
@@ -125,6 +135,11 @@ private:
  * New cards may be dropped on the stack must satisfy the following conditions
  *  a) Card must have the opposite color value
  *  b) Card must be one value Lower than top face up card
+ *
+ * In column mode the stack paints all of its cards from the CardAtlas in its own paint(),
+ * with a DeviceCoordinateCache, instead of being one scene item per card.  A hover or a
+ * flip then repaints one cached item rather than every overlapping card, and the cache
+ * is only rebuilt when the column changes.
  */
 class DescendingStack: public CardStack {
     Q_OBJECT
@@ -140,27 +155,32 @@ public:
 
     virtual void newGame() override;
 
-    virtual bool canAdd(Card& card) const override;
     virtual void addCard(Card *card, bool flipTop) override;
-    virtual Card* takeTop() override;
-    QList<Card*> takeCards(Card& card);
 
     double getYOffset() const;
-
+    QPointF cardPos(int index) const override;
 
     QRectF boundingRect() const override;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
-    void dropEvent(QGraphicsSceneDragDropEvent *event) override;
-
     virtual void fanCards(FanDirection dir) override;
 
+    void setColumnMode(bool columnMode);
+    bool paintsCards() const override { return mColumnMode; }
+    Card* cardAt(const QPointF& pos) const override;
+
 protected slots:
     void fanAnimationFinished();
-    void onUpdateState(QAbstractAnimation::State newState, QAbstractAnimation::State oldState);
 
 protected:
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event) override;
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent *event) override;
 
+private:
+    void setHoverIndex(int index);
+
+    bool mColumnMode;                   ///< Paint the whole column in one item, see setColumnMode()
+    int mHoverIndex;                    ///< Card under the pointer in column mode, or -1
 };
 
 typedef DescendingStack* pDStack;   ///< Pointer to DescendingStack
@@ -186,8 +206,6 @@ public:
 
     virtual void newGame() override;
 
-    virtual bool canAdd(Card& card) const override;
-
     virtual void addCard(Card *card, bool flipTop) override;
 
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
@@ -196,7 +214,6 @@ public:
 
 protected slots:
     void fanAnimationFinished();
-    void onUpdateState(QAbstractAnimation::State newState, QAbstractAnimation::State oldState);
 
 protected:
 };
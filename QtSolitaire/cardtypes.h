@@ -0,0 +1,72 @@
+#ifndef CARDTYPES_H
+#define CARDTYPES_H
+
+#include "enumiterator.h"
+
+#include <cstdint>
+
+/**
+  * @brief Card identity types shared by the Qt scene and the headless game engine.
+  *
+  * Nothing in here depends on Qt, so the engine (gamestate.h and friends) can be
+  * built into command line tools that never create a QApplication.
+  */
+
+enum class CardValue {
+    ACE = 1,
+    TWO,
+    THREE,
+    FOUR,
+    FIVE,
+    SIX,
+    SEVEN,
+    EIGHT,
+    NINE,
+    TEN,
+    JACK,
+    QUEEN,
+    KING
+};
+typedef enumIterator<CardValue, CardValue::ACE, CardValue::KING> CardValueIterator;
+
+enum class Suit {
+    HEART,
+    DIAMOND,
+    SPADE,
+    CLUB
+};
+typedef enumIterator<Suit, Suit::HEART, Suit::CLUB> SuitIterator;
+
+enum class Colors {
+    RED,
+    BLACK
+};
+typedef enumIterator<Colors, Colors::RED, Colors::BLACK> ColorsIterator;
+
+/**
+ * @brief CardId is a one byte card number: suit * 13 + (value - 1)
+ *
+ * Hearts are 0..12, Diamonds 13..25, Spades 26..38 and Clubs 39..51, so the two
+ * red suits occupy ids 0..25 and the two black suits ids 26..51.
+ */
+typedef uint8_t CardId;
+
+static const int NUM_SUITS{4};
+static const int CARDS_PER_SUIT{13};
+static const int NUM_CARDS{NUM_SUITS*CARDS_PER_SUIT};
+static const CardId NO_CARD{0xFF};
+
+constexpr CardId makeCardId(Suit s, CardValue v) {
+    return static_cast<CardId>(static_cast<int>(s)*CARDS_PER_SUIT + static_cast<int>(v) - 1);
+}
+
+constexpr int cardSuitIndex(CardId id) { return id / CARDS_PER_SUIT; }
+constexpr Suit cardSuit(CardId id) { return static_cast<Suit>(cardSuitIndex(id)); }
+
+/** @brief rank of the card: Ace = 1 ... King = 13 */
+constexpr int cardRank(CardId id) { return id % CARDS_PER_SUIT + 1; }
+constexpr CardValue cardValue(CardId id) { return static_cast<CardValue>(cardRank(id)); }
+
+constexpr bool isRedCard(CardId id) { return id < 2*CARDS_PER_SUIT; }
+
+#endif // CARDTYPES_H
@@ -18,13 +18,4 @@ static const int NUM_PLAY_STACKS{7};
 static const double SVG_SCALEF{0.078};            // SVG Scale Factor
 static const double CARD_RADIUS{CARD_WIDTH/10.0};
 
-static const char CARD_MIME_TYPE[] {"application/x-card"};
-
-enum class DEBUG_LEVEL {
-    NONE,
-    NORMAL,
-    VERBOSE
-};
-static const DEBUG_LEVEL debugLevel{DEBUG_LEVEL::NORMAL};
-
 #endif // CONSTANTS_H
@@ -1,11 +1,10 @@
 #include "deck.h"
 #include "constants.h"
+#include "renderstats.h"
+#include "shuffle.h"
 
 #include <QPainter>
 
-#include <algorithm>
-#include <random>
-
 Deck::Deck(bool showDeck, QGraphicsItem *parent, QUndoStack *undoStack)
     :RandomStack(parent, undoStack)
     ,mShowDeck(showDeck)
@@ -29,6 +28,7 @@ void Deck::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWid
 {
     Q_UNUSED(option);
     Q_UNUSED(widget);
+    RenderStats::countPaint();
     painter->save();
     painter->setBrush(Qt::NoBrush);
     painter->drawRoundedRect(boundingRect(), CARD_RADIUS, CARD_RADIUS);
@@ -43,11 +43,27 @@ void Deck::addCard(Card* card, bool flipTop)
     card->setPos(x, y);
 }
 
-void Deck::shuffle()
+/**
+ * @brief shuffle the deck into the order of a numbered game, see shuffledDeck()
+ *
+ * The cards are laid out in the order shuffledDeck() picks from a new deck, whatever
+ * order they were collected in, so the game number alone decides the deal.
+ */
+void Deck::shuffle(quint64 gameNumber)
 {
-    std::random_device rd;
-    std:std::mt19937 rng(rd());
-    std::shuffle(mCards.begin(), mCards.end(), rng);
+    CardId order[NUM_CARDS];
+    shuffledDeck(gameNumber, order);
+
+    Card *byId[NUM_CARDS]{};
+    for (Card *card : mCards) {
+        byId[card->cardId()] = card;
+    }
+    mCards.clear();
+    for (CardId id : order) {
+        if (byId[id]) {
+            mCards.append(byId[id]);
+        }
+    }
 }
 
 Card* Deck::deal()
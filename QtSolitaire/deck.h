@@ -23,7 +23,7 @@ public:
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
 
     void addCard(Card* card, bool flipTop) override;
-    void shuffle();
+    void shuffle(quint64 gameNumber);
     Card* deal();
 
 private:
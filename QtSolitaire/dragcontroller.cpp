@@ -0,0 +1,231 @@
+#include "dragcontroller.h"
+
+#include "card.h"
+#include "cardatlas.h"
+#include "cardstack.h"
+#include "constants.h"
+#include "game.h"
+#include "logging.h"
+#include "rules.h"
+#include "tablelayout.h"
+#include "trace.h"
+
+#include <QDebug>
+#include <QDrag>
+#include <QElapsedTimer>
+#include <QGraphicsPixmapItem>
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QMimeData>
+#include <QStringList>
+
+static const qreal DRAG_Z{1000.0};          ///< Above every stack on the table
+static const double SNAP_DISTANCE{CARD_HEIGHT/2.0};  ///< How far off a legal pile a drop still lands on it
+static const qint64 DRAG_START_BUDGET_NS{16666667};  ///< One frame at 60 Hz
+
+DragController::DragController(Game *game, QGraphicsScene *scene)
+    : QObject{game}
+    , mGame{game}
+    , mScene{scene}
+    , mPixmapItem{new QGraphicsPixmapItem()}
+    , mActive{false}
+    , mFrom{NUM_PILES}
+    , mCard{NO_CARD}
+    , mCount{0}
+    , mTargets{0}
+    , mTarget{NUM_PILES}
+{
+    mPixmapItem->setZValue(DRAG_Z);
+    mPixmapItem->setAcceptedMouseButtons(Qt::NoButton);
+    mPixmapItem->setVisible(false);
+    mScene->addItem(mPixmapItem);
+}
+
+/**
+ * @brief onDragMoved - the pointer moved while a card is held down, start or follow the drag
+ */
+void DragController::onDragMoved(Card& card, const QPointF& scenePos, const QPoint& screenPos)
+{
+    if (!mActive && !begin(card, scenePos)) {
+        return;
+    }
+
+    // Leaving the window hands the drag over to the platform
+    const QList<QGraphicsView*> views = mScene->views();
+    if (!views.isEmpty()) {
+        QWidget *viewport = views.first()->viewport();
+        if (!viewport->rect().contains(viewport->mapFromGlobal(screenPos))) {
+            dragOutside();
+            return;
+        }
+    }
+
+    mPixmapItem->setPos(scenePos - mHotSpot);
+    setTarget(targetAt(scenePos));
+}
+
+/**
+ * @brief onDragReleased - drop the run on the pile under the pointer, if it takes it
+ */
+void DragController::onDragReleased(Card& card, const QPointF& scenePos)
+{
+    Q_UNUSED(card);
+    if (!mActive) {
+        return;
+    }
+    Pile to = targetAt(scenePos);
+    Move move(mFrom, to, mCount);
+    end();
+    if (to != NUM_PILES) {
+        mGame->pushMove(move);
+    }
+}
+
+void DragController::cancel()
+{
+    if (mActive) {
+        end();
+    }
+}
+
+/**
+ * @brief begin - pick up card and the cards on top of it, if the rules let it move at all
+ */
+bool DragController::begin(Card& card, const QPointF& scenePos)
+{
+    TRACE_SPAN("event", "DragController::begin");
+    QElapsedTimer timer;
+    timer.start();
+
+    const GameState& state = mGame->state();
+    const Bitboards boards(state);
+    const CardId id = card.cardId();
+
+    Pile from{NUM_PILES};
+    for (int p = 0; p < NUM_PILES; ++p) {
+        if ((boards.pile[p] >> id) & 1) {
+            from = static_cast<Pile>(p);
+            break;
+        }
+    }
+    if (from == NUM_PILES || from == PILE_HAND || !boards.canTakeRun(from, id)) {
+        return false;
+    }
+
+    int count{0};
+    while (state.cardAt(from, state.pileSize(from) - 1 - count) != id) {
+        count++;
+    }
+    count++;
+
+    mTargets = 0;
+    for (int p = PILE_FOUNDATION; p < NUM_PILES; ++p) {
+        if (p != from && boards.canAdd(static_cast<Pile>(p), id) && (isTableauPile(p) || count == 1)) {
+            mTargets |= 1u << p;
+        }
+    }
+
+    mActive = true;
+    mFrom = from;
+    mCard = id;
+    mCount = count;
+    mTarget = NUM_PILES;
+
+    // The run is lifted off the table, and its picture follows the pointer instead
+    QVector<CardId> run;
+    CardStack *stack = mGame->stackFor(from);
+    for (int i = state.pileSize(from) - count; i < state.pileSize(from); ++i) {
+        CardId runCard = state.cardAt(from, i);
+        run.append(runCard);
+        stack->cardItem(runCard)->setVisible(false);
+    }
+    stack->setLifted(count);
+    const QList<QGraphicsView*> views = mScene->views();
+    qreal dpr = views.isEmpty() ? 1.0 : views.first()->devicePixelRatioF();
+    mPixmapItem->setPixmap(CardAtlas::runPixmap(run, dpr));
+    mHotSpot = scenePos - card.mapToScene(card.boundingRect().topLeft());
+    mPixmapItem->setPos(scenePos - mHotSpot);
+    mPixmapItem->setVisible(true);
+    if (!views.isEmpty()) {
+        views.first()->viewport()->setCursor(Qt::ClosedHandCursor);
+    }
+
+    qint64 startNs = timer.nsecsElapsed();
+    if (startNs > DRAG_START_BUDGET_NS) {
+        qCInfo(lcDrag) << "Slow drag start of" << count << "cards took" << startNs / 1000 << "us";
+    } else {
+        qCDebug(lcDrag) << "Drag start of" << count << "cards took" << startNs / 1000 << "us";
+    }
+    return true;
+}
+
+void DragController::end()
+{
+    const GameState& state = mGame->state();
+    CardStack *stack = mGame->stackFor(mFrom);
+    for (int i = state.pileSize(mFrom) - mCount; i < state.pileSize(mFrom); ++i) {
+        stack->cardItem(state.cardAt(mFrom, i))->setVisible(!stack->paintsCards());
+    }
+    stack->setLifted(0);
+    setTarget(NUM_PILES);
+    mPixmapItem->setVisible(false);
+    const QList<QGraphicsView*> views = mScene->views();
+    if (!views.isEmpty()) {
+        views.first()->viewport()->unsetCursor();
+    }
+    mActive = false;
+}
+
+/**
+ * @brief targetAt - the legal pile a drop at scenePos lands on, or NUM_PILES
+ *
+ * That is the pile under the pointer if it takes the run, else the legal pile nearest
+ * to where the grabbed card is, if it is close enough to snap to.
+ */
+Pile DragController::targetAt(const QPointF& scenePos) const
+{
+    const GameState& state = mGame->state();
+    Pile pile = TableLayout::pileAt(scenePos, state);
+    if ((mTargets >> pile) & 1) {
+        return pile;
+    }
+    const QPointF cardCentre = scenePos - mHotSpot + QPointF(CARD_WIDTH/2.0, CARD_HEIGHT/2.0);
+    return TableLayout::nearestPile(cardCentre, mTargets, state, SNAP_DISTANCE);
+}
+
+void DragController::setTarget(Pile pile)
+{
+    if (pile == mTarget) {
+        return;
+    }
+    if (mTarget != NUM_PILES) {
+        mGame->stackFor(mTarget)->setDragOver(false);
+    }
+    mTarget = pile;
+    if (mTarget != NUM_PILES) {
+        mGame->stackFor(mTarget)->setDragOver(true);
+    }
+}
+
+/**
+ * @brief dragOutside - continue the drag outside the window as a plain text QDrag
+ */
+void DragController::dragOutside()
+{
+    const GameState& state = mGame->state();
+    QStringList names;
+    for (int i = state.pileSize(mFrom) - mCount; i < state.pileSize(mFrom); ++i) {
+        names.append(Card::cardText(state.cardAt(mFrom, i)));
+    }
+    QPixmap pixmap = mPixmapItem->pixmap();
+    QPoint hotSpot = mHotSpot.toPoint();
+    end();
+
+    QMimeData *mime = new QMimeData;
+    mime->setText(names.join(' '));
+    QDrag *drag = new QDrag(mScene->views().first()->viewport());
+    drag->setMimeData(mime);
+    drag->setPixmap(pixmap);
+    drag->setHotSpot(hotSpot);
+    drag->exec(Qt::CopyAction);
+}
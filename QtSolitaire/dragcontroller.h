@@ -0,0 +1,65 @@
+#ifndef DRAGCONTROLLER_H
+#define DRAGCONTROLLER_H
+
+#include "cardtypes.h"
+#include "gamestate.h"
+#include "moves.h"
+
+#include <QObject>
+#include <QPointF>
+#include <QPoint>
+
+class Card;
+class CardStack;
+class Game;
+QT_FORWARD_DECLARE_CLASS(QGraphicsPixmapItem)
+QT_FORWARD_DECLARE_CLASS(QGraphicsScene)
+
+/**
+ * @brief The DragController class drags cards around the scene without QDrag
+ *
+ * A drag is just the source pile, the grabbed card and the run on top of it.  When it
+ * starts, the rules engine works out once which piles could take the run; while it
+ * moves, a single pixmap item follows the pointer and the pile it would land on is
+ * highlighted: the one under the pointer, found by TableLayout, or else the nearest
+ * legal one close enough to snap to.  On release the move is pushed through
+ * Game::pushMove().  No
+ * QMimeData is built and nothing is cast or deserialized on the drop path.
+ *
+ * Only a drag that leaves the window turns into a real QDrag, carrying the cards as
+ * plain text for other applications.
+ */
+class DragController : public QObject
+{
+    Q_OBJECT
+public:
+    DragController(Game *game, QGraphicsScene *scene);
+
+    bool isDragging() const { return mActive; }
+
+public slots:
+    void onDragMoved(Card& card, const QPointF& scenePos, const QPoint& screenPos);
+    void onDragReleased(Card& card, const QPointF& scenePos);
+    void cancel();
+
+private:
+    bool begin(Card& card, const QPointF& scenePos);
+    void end();
+    Pile targetAt(const QPointF& scenePos) const;
+    void setTarget(Pile pile);
+    void dragOutside();
+
+    Game *mGame;
+    QGraphicsScene *mScene;
+    QGraphicsPixmapItem *mPixmapItem;   ///< Picture of the dragged run, hidden when idle
+
+    bool mActive;
+    Pile mFrom;
+    CardId mCard;
+    int mCount;                         ///< Cards in the run, mCard at the bottom
+    unsigned mTargets;                  ///< Bit p set if pile p takes the run
+    Pile mTarget;                       ///< Highlighted pile under the pointer, or NUM_PILES
+    QPointF mHotSpot;                   ///< Pointer position in the run picture
+};
+
+#endif // DRAGCONTROLLER_H
@@ -1,21 +1,50 @@
 #include "game.h"
 
 #include "card.h"
+#include "cardanimator.h"
 #include "cardstack.h"
 #include "clickableitem.h"
 #include "constants.h"
 #include "deck.h"
+#include "dragcontroller.h"
+#include "logging.h"
+#include "moves.h"
 #include "myscene.h"
+#include "perfhud.h"
+#include "renderstats.h"
+#include "scenetransaction.h"
+#include "tablelayout.h"
+#include "shuffle.h"
+#include "trace.h"
 #include "undocommands.h"
 
 #include <QApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QGraphicsRectItem>
 #include <QDebug>
+#include <QElapsedTimer>
 #include <QGraphicsView>
 #include <QMessageBox>
 #include <QMenuBar>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QRandomGenerator>
 #include <QUndoCommand>
 
 const bool showDeck{true};  //< Debug flag to show initial state of deck.
+
+// New Game animation timeline, see Game::newGame()
+const int COLLECT_DURATION_MS{300};         ///< Time for a card to fly back to the hand
+const int COLLECT_STAGGER_MS{4};            ///< Delay between cards leaving for the hand
+const int FLOURISH_DURATION_MS{120};        ///< Time for each half of the shuffle riffle
+const int DEAL_DURATION_MS{250};            ///< Time for a card to fly to its stack
+const int DEAL_STAGGER_MS{30};              ///< Delay between cards being dealt
+
+const qreal KEYBOARD_CURSOR_Z{900.0};       ///< Keyboard cursor is drawn above the cards
+
 /**
  * @brief Game Constructor
  *
@@ -23,22 +52,39 @@ const bool showDeck{true};  //< Debug flag to show initial state of deck.
  */
 Game::Game(QWidget* parent, QMenuBar *menubar)
     : QGraphicsView{parent}
+    , mCardItems{}
+    , mGameNumber{0}
     , mScene{nullptr}
+    , mDragController{nullptr}
+    , mHud{nullptr}
+    , mCursorItem{nullptr}
+    , mSelectionItem{nullptr}
+    , mCursorColumn{0}
+    , mCursorTableau{false}
+    , mSelected{NUM_PILES}
     , mDeck{nullptr}
     , mHand{nullptr}
     , mWastePile{nullptr}
     , mHearts{nullptr}
     , mDiamonds{nullptr}
-    , mSpades{nullptr}
     , mClubs{nullptr}
-    , mUndoStack{nullptr}
+    , mSpades{nullptr}
     , mMenuBar{menubar}
+    , mUndoStack{nullptr}
 {
     mUndoStack = QSharedPointer<QUndoStack>(new QUndoStack(), &QObject::deleteLater);
 
     mScene = new  myScene(0, 0, GAME_WIDTH, GAME_HEIGHT, parent);
     mScene->setSceneRect(QRectF(0, 0, GAME_WIDTH, GAME_HEIGHT));
     this->setScene(mScene);
+    mDragController = new DragController(this, mScene);
+    mHud = new PerfHud(this, mUndoStack.data());
+
+    // The scene reports what the mouse does to the cards, see myScene
+    QObject::connect(mScene, &myScene::cardClicked, this, &Game::onCardClicked);
+    QObject::connect(mScene, &myScene::cardDoubleClicked, this, &Game::onCardDoubleClicked);
+    QObject::connect(mScene, &myScene::cardDragMoved, mDragController, &DragController::onDragMoved);
+    QObject::connect(mScene, &myScene::cardDragReleased, mDragController, &DragController::onDragReleased);
 
     createDeck(mScene, &mDeck);                         // Create the deck
     createCards(mScene, mDeck);                         // Create the cards and place them in the deck
@@ -56,12 +102,181 @@ Game::Game(QWidget* parent, QMenuBar *menubar)
 
 void Game::showEvent(QShowEvent *event)
 {
+    Q_UNUSED(event);
 
     this->setRenderHint(QPainter::Antialiasing);
     this->setViewportUpdateMode(QGraphicsView::BoundingRectViewportUpdate);
     this->setBackgroundBrush(QColor(22, 161, 39));      // A medium dark green
  }
 
+/**
+ * @brief paintEvent - paint the view, timing the frame for the PerfHud while it is shown
+ *
+ * The HUD's own refreshes, which repaint nothing but its corner, are not frames of the
+ * game and are left out of its figures.
+ */
+void Game::paintEvent(QPaintEvent *event)
+{
+    TRACE_SPAN("paint", "Game::paintEvent");
+    if (!mHud->isVisible() || mHud->rect().contains(event->region().boundingRect())) {
+        QGraphicsView::paintEvent(event);
+        return;
+    }
+    const quint64 paints = RenderStats::paints();
+    QElapsedTimer timer;
+    timer.start();
+    QGraphicsView::paintEvent(event);
+    mHud->frameFinished(timer.nsecsElapsed(), RenderStats::paints() - paints);
+}
+
+/**
+ * @brief drawForeground - the PerfHud goes on top of the scene, in view coordinates
+ */
+void Game::drawForeground(QPainter *painter, const QRectF& rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+    if (mHud->isVisible()) {
+        painter->save();
+        painter->resetTransform();
+        mHud->paint(painter);
+        painter->restore();
+    }
+}
+
+/**
+ * @brief mousePressEvent - playing before an animation ends skips the rest of it
+ */
+void Game::mousePressEvent(QMouseEvent *event)
+{
+    TRACE_SPAN("event", "Game::mousePressEvent");
+    CardAnimator::instance()->finishAll();
+    hideKeyboardCursor();
+    QGraphicsView::mousePressEvent(event);
+}
+
+/**
+ * @brief keyPressEvent - keyboard play
+ *
+ * The arrow keys move a cursor over the piles as TableLayout lays them out.  Space or
+ * Return on the hand draws a card (or turns the waste pile over); on any other pile the
+ * first press picks up its top card or run and the second plays it onto the pile under
+ * the cursor, if the rules allow.  Escape lets go of the selection.  F3 shows or hides
+ * the PerfHud, F4 starts and saves a trace, see toggleTrace().
+ */
+void Game::keyPressEvent(QKeyEvent *event)
+{
+    TRACE_SPAN("event", "Game::keyPressEvent");
+    if (event->key() == Qt::Key_F3) {
+        mHud->setVisible(!mHud->isVisible());
+        event->accept();
+        return;
+    }
+    if (event->key() == Qt::Key_F4) {
+        toggleTrace();
+        event->accept();
+        return;
+    }
+    CardAnimator::instance()->finishAll();
+    switch (event->key()) {
+    case Qt::Key_Left:
+        moveCursor(-1, 0);
+        break;
+    case Qt::Key_Right:
+        moveCursor(1, 0);
+        break;
+    case Qt::Key_Up:
+        moveCursor(0, -1);
+        break;
+    case Qt::Key_Down:
+        moveCursor(0, 1);
+        break;
+    case Qt::Key_Space:
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        playAtCursor();
+        break;
+    case Qt::Key_Escape:
+        mDragController->cancel();
+        mSelected = NUM_PILES;
+        showKeyboardCursor();
+        break;
+    default:
+        QGraphicsView::keyPressEvent(event);
+        return;
+    }
+    event->accept();
+}
+
+void Game::moveCursor(int dx, int dy)
+{
+    bool tableau = dy ? (dy > 0) : mCursorTableau;
+    int column = qBound(0, mCursorColumn + dx, NUM_PLAY_STACKS - 1);
+    if (TableLayout::pileAt(column, tableau) == NUM_PILES) {
+        // Step over the gap between the waste pile and the foundations
+        column += (dx > 0) ? 1 : -1;
+    }
+    mCursorColumn = column;
+    mCursorTableau = tableau;
+    showKeyboardCursor();
+}
+
+void Game::playAtCursor()
+{
+    Pile pile = TableLayout::pileAt(mCursorColumn, mCursorTableau);
+    if (mSelected == NUM_PILES) {
+        if (pile == PILE_HAND) {
+            if (mState.pileSize(PILE_HAND) > 0) {
+                pushMove(Move(PILE_HAND, PILE_WASTE, 1));
+            } else if (mState.pileSize(PILE_WASTE) > 0) {
+                pushMove(Move(PILE_WASTE, PILE_HAND, mState.pileSize(PILE_WASTE)));
+            }
+        } else if (mState.pileSize(pile) > 0 && mState.isFaceUp(mState.top(pile))) {
+            mSelected = pile;
+        }
+    } else {
+        MoveList moves;
+        generateMoves(mState, moves);
+        for (const Move& m : moves) {
+            if (m.from() == mSelected && m.to() == pile) {
+                pushMove(m);
+                break;
+            }
+        }
+        mSelected = NUM_PILES;
+    }
+    showKeyboardCursor();
+}
+
+void Game::showKeyboardCursor()
+{
+    if (!mCursorItem) {
+        mCursorItem = new QGraphicsRectItem();
+        mCursorItem->setPen(QPen(QColor(255, 215, 0), 3));
+        mCursorItem->setZValue(KEYBOARD_CURSOR_Z);
+        mScene->addItem(mCursorItem);
+
+        mSelectionItem = new QGraphicsRectItem();
+        mSelectionItem->setPen(QPen(Qt::white, 2, Qt::DashLine));
+        mSelectionItem->setZValue(KEYBOARD_CURSOR_Z);
+        mScene->addItem(mSelectionItem);
+    }
+    mCursorItem->setRect(TableLayout::dropRect(TableLayout::pileAt(mCursorColumn, mCursorTableau), mState));
+    mCursorItem->setVisible(true);
+    if (mSelected != NUM_PILES) {
+        mSelectionItem->setRect(TableLayout::dropRect(mSelected, mState));
+    }
+    mSelectionItem->setVisible(mSelected != NUM_PILES);
+}
+
+void Game::hideKeyboardCursor()
+{
+    mSelected = NUM_PILES;
+    if (mCursorItem) {
+        mCursorItem->setVisible(false);
+        mSelectionItem->setVisible(false);
+    }
+}
+
  /**
   * @brief Create the Deck
   *
@@ -91,8 +306,7 @@ void Game::createCards(myScene *scene, Deck *deck) {
             Card *item = new Card(value, suit, nullptr);
             item->setPos(30+(double)(value)*30.0, 3*CARD_HEIGHT/2+2*TOP_MARGIN+(double)suit*22);
 
-            QObject::connect(item, &Card::clicked, this, &Game::onCardClicked);
-            QObject::connect(item, &Card::doubleClicked, this, &Game::onCardDoubleClicked);
+            mCardItems[item->cardId()] = item;
             scene->addItem(item);
             deck->addCard(item, false);
         }
@@ -113,13 +327,15 @@ void Game::createHandAndWaste(myScene* scene, RandomStack **hand, RandomStack **
     }
 
     (*hand) = new RandomStack(nullptr, mUndoStack.data());
-    (*hand)->setPos(CARD_SPACING+CARD_WIDTH/2, TOP_MARGIN+CARD_HEIGHT/2);
+    (*hand)->attachModel(&mState, mCardItems, PILE_HAND);
+    (*hand)->setPos(TableLayout::pilePos(PILE_HAND));
     QObject::connect( (*hand), &CardStack::clicked, this, &Game::onEmptyHandClicked);
 
     scene->addItem( (*hand));
 
     (*wastePile) = new RandomStack(nullptr, mUndoStack.data());
-    (*wastePile)->setPos(2*CARD_SPACING+ 3*CARD_WIDTH/2, TOP_MARGIN+CARD_HEIGHT/2);
+    (*wastePile)->attachModel(&mState, mCardItems, PILE_WASTE);
+    (*wastePile)->setPos(TableLayout::pilePos(PILE_WASTE));
     scene->addItem((*wastePile));
 }
 /**
@@ -138,7 +354,8 @@ void Game::createFoundation(myScene *scene, SortedStack **hearts, SortedStack **
 
     for (Suit suit: SuitIterator()) {
         SortedStack *stack = new SortedStack(suit, nullptr, mUndoStack.data());
-        stack->setPos(4*CARD_SPACING+3*CARD_WIDTH + CARD_WIDTH/2 + (double)suit*(CARD_WIDTH+CARD_SPACING), TOP_MARGIN+CARD_HEIGHT/2);
+        stack->attachModel(&mState, mCardItems, foundationPile(suit));
+        stack->setPos(TableLayout::pilePos(foundationPile(suit)));
         stack->setTransform(QTransform::fromScale(1.0, 1.0), true);
         scene->addItem(stack);
         switch(suit) {
@@ -163,7 +380,8 @@ void Game::createPlayfield(myScene *scene, pDStackArray stacks){
 
     for (int i = 0; i < NUM_PLAY_STACKS; i++) {
         stacks[i] = new DescendingStack(nullptr, mUndoStack.data());
-        stacks[i]->setPos(CARD_SPACING + CARD_WIDTH/2 + (double)i*(CARD_WIDTH+CARD_SPACING), +TOP_MARGIN+ 3*CARD_HEIGHT/2 + CARD_SPACING);
+        stacks[i]->attachModel(&mState, mCardItems, tableauPile(i));
+        stacks[i]->setPos(TableLayout::pilePos(tableauPile(i)));
         scene->addItem(mPlayStacks[i]);
     }
 }
@@ -276,6 +494,39 @@ void Game::createMenus() {
     }
 }
 
+/**
+ * @brief stackFor - find the scene stack that mirrors a pile of the model
+ */
+CardStack* Game::stackFor(Pile pile) const
+{
+    if (pile == PILE_HAND) {
+        return mHand;
+    } else if (pile == PILE_WASTE) {
+        return mWastePile;
+    } else if (isFoundationPile(pile)) {
+        switch (static_cast<Suit>(pile - PILE_FOUNDATION)) {
+        case Suit::HEART: return mHearts;
+        case Suit::DIAMOND: return mDiamonds;
+        case Suit::SPADE: return mSpades;
+        case Suit::CLUB: return mClubs;
+        }
+    } else if (isTableauPile(pile)) {
+        return mPlayStacks[pile - PILE_TABLEAU];
+    }
+    return nullptr;
+}
+
+/**
+ * @brief syncScene - lay out every stack on the table to match the model
+ */
+void Game::syncScene()
+{
+    SceneTransaction transaction(mScene);
+    for (int p = 0; p < NUM_PILES; ++p) {
+        stackFor(static_cast<Pile>(p))->syncFromModel();
+    }
+}
+
 void Game::onUndoAction(bool checked) {
     Q_UNUSED(checked);
     onUndoClicked();
@@ -283,8 +534,6 @@ void Game::onUndoAction(bool checked) {
 
 void Game::onUndoClicked()
 {
-    QUndoCommand *undo{nullptr};
-
     if (mUndoStack->canUndo()) {
         mUndoStack->undo();
     }
@@ -303,6 +552,7 @@ void Game::onRedoClicked()
 }
 
 void Game::onCleanChanged(bool clean) {
+    Q_UNUSED(clean);
 
     undoAction->setEnabled(mUndoStack->canUndo());
     redoAction->setEnabled(mUndoStack->canRedo());
@@ -327,6 +577,7 @@ void Game::onEmptyHandClicked(CardStack& stack)
         return;
     }
     if (&stack == mHand) {
+        TRACE_SPAN("undo", "QUndoStack::push");
         mUndoStack->push(new ResetHandCommand(mHand, mWastePile));
     }
 }
@@ -336,78 +587,76 @@ void Game::onCardClicked(Card& card)
     // Cards on the hand can move to the waste pile
     if (card.parentItem() == mHand) {
         HandToWasteCommand *command = new HandToWasteCommand(mHand, mWastePile);
+        TRACE_SPAN("undo", "QUndoStack::push");
         mUndoStack->push(command);
     }
 
 }
 
+/**
+ * @brief onCardDoubleClicked - play the card to its foundation, or else the first tableau column that takes it
+ *
+ * Only the top card of the waste pile or of a tableau column can be double clicked away.
+ */
 void Game::onCardDoubleClicked(Card& card)
 {
     CardStack *fromStack = dynamic_cast<CardStack*>(card.parentItem());
-    if (fromStack == nullptr) {
+    if (fromStack == nullptr || (fromStack->pile() != PILE_WASTE && !isTableauPile(fromStack->pile()))) {
         return;
     }
 
-    // Move card from Waste Pile to Foundation (Sorted Stacks Per-Suit)
-    SortedStack* sStack{nullptr};
-    for (Suit suit: SuitIterator()) {
-        switch(suit) {
-        case Suit::HEART: sStack = mHearts; break;
-        case Suit::DIAMOND: sStack = mDiamonds; break;
-        case Suit::CLUB:   sStack = mClubs; break;
-        case Suit::SPADE:  sStack = mSpades; break;
-        }
-
-        if (fromStack->canTake(card) && sStack->canAdd(card)) {
-            if (card.parentItem() == mWastePile) {
-                WasteToFoundationCommand *command = new WasteToFoundationCommand(mWastePile, sStack);
-                mUndoStack->push(command);
-                return;
-            }
-        }
-    }
+    MoveList moves;
+    generateMoves(mState, moves);
 
-    // Move card from Waste Pile to main playfield
-    if (card.parentItem() == mWastePile) {
-        for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
-            if (fromStack->canTake(card) && mPlayStacks[i]->canAdd(card)) {
-                MoveToPlayfieldCommand *command = new MoveToPlayfieldCommand(mWastePile, mPlayStacks[i]);
-                mUndoStack->push(command);
-                return;
-            }
+    Move best;
+    for (const Move& m : moves) {
+        if (m.from() != fromStack->pile() || m.count() != 1 || movedCard(mState, m) != card.cardId()) {
+            continue;
         }
-    }
-
-    // Check if card can move from main playfield to the Foundation Piles (Sorted Stacks)
-    for (Suit suit: SuitIterator()) {
-        switch(suit) {
-        case Suit::HEART: sStack = mHearts; break;
-        case Suit::DIAMOND: sStack = mDiamonds; break;
-        case Suit::CLUB:   sStack = mClubs; break;
-        case Suit::SPADE:  sStack = mSpades; break;
+        if (isFoundationPile(m.to())) {
+            best = m;
+            break;
         }
-        for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
-            if (card.parentItem() == mPlayStacks[i] && mPlayStacks[i]->canTake(card) && sStack->canAdd(card)) {
-                PlayfieldToFoundationCommand *command = new PlayfieldToFoundationCommand(mPlayStacks[i], sStack);
-                mUndoStack->push(command);
-                return;
-            }
+        if (best.isNull() && isTableauPile(m.to())) {
+            best = m;
         }
     }
+    if (!best.isNull()) {
+        pushMove(best);
+    }
+}
 
-    // Handle cards moving from one of the main playfield stacks to a different main playfield stack
-    for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
-        for (int j = 0; j < NUM_PLAY_STACKS; ++j) {
-            if (i == j) {
-                continue;
-            }
-            if (card.parentItem() == mPlayStacks[i] && fromStack->canTake(card) && mPlayStacks[j]->canAdd(card)) {
-                PlayfieldToPlayfieldCommand *command = new PlayfieldToPlayfieldCommand(mPlayStacks[i], mPlayStacks[j]);
-                mUndoStack->push(command);
-                return;
-            }
+/**
+ * @brief pushMove - push the undo command that carries out a move from the move generator
+ */
+void Game::pushMove(const Move& move)
+{
+    CardStack *from = stackFor(move.from());
+    CardStack *to = stackFor(move.to());
+    QUndoCommand *command{nullptr};
+
+    if (move.from() == PILE_HAND) {
+        command = new HandToWasteCommand(mHand, mWastePile);
+    } else if (move.from() == PILE_WASTE) {
+        if (move.to() == PILE_HAND) {
+            command = new ResetHandCommand(mHand, mWastePile);
+        } else if (isFoundationPile(move.to())) {
+            command = new WasteToFoundationCommand(mWastePile, static_cast<SortedStack*>(to));
+        } else {
+            command = new MoveToPlayfieldCommand(mWastePile, static_cast<DescendingStack*>(to));
         }
+    } else if (isFoundationPile(move.from())) {
+        command = new DragFoundationToPlayfieldCommand(static_cast<SortedStack*>(from), static_cast<DescendingStack*>(to));
+    } else if (isFoundationPile(move.to())) {
+        command = new PlayfieldToFoundationCommand(static_cast<DescendingStack*>(from), static_cast<SortedStack*>(to));
+    } else if (move.count() == 1) {
+        command = new PlayfieldToPlayfieldCommand(static_cast<DescendingStack*>(from), static_cast<DescendingStack*>(to));
+    } else {
+        Card *first = mCardItems[movedCard(mState, move)];
+        command = new DragPlayfieldToPlayfieldCommand(first, static_cast<DescendingStack*>(from), static_cast<DescendingStack*>(to));
     }
+    TRACE_SPAN("undo", "QUndoStack::push");
+    mUndoStack->push(command);
 }
 
 static FanDirection direction = FanDirection::FOUR_ROWS;
@@ -419,8 +668,24 @@ void Game::onShuffleAction(bool checked) {
 
 void Game::onShuffleClicked()
 {
-    qDebug() << __func__;
-    mDeck->shuffle();
+    qCDebug(lcGame) << __func__;
+    shuffle(QRandomGenerator::global()->generate());
+}
+
+/**
+ * @brief shuffle the deck into numbered game gameNumber, the same deal on every machine
+ */
+void Game::shuffle(quint64 gameNumber)
+{
+    qCDebug(lcGame) << __func__ << gameNumber;
+    // Only a full deck can be shuffled into a numbered game
+    if (!mDeck || mDeck->isEmpty()) {
+        return;
+    }
+    mDeck->shuffle(gameNumber);
+    mGameNumber = gameNumber;
+    emit gameNumberChanged(gameNumber);
+
     mDeck->fanCards(direction);
     if (direction == FanDirection::FOUR_ROWS) {
         direction = FanDirection::HORIZONTAL;
@@ -439,41 +704,21 @@ void Game::onDealAction(bool checked) {
 
 void Game::onDealClicked()
 {
-    qDebug() << __func__;
+    qCDebug(lcGame) << __func__;
     // This check is sufficent, because the deck is either full or empty at all times, except
     // during the excution of this method.
     if (!mDeck || mDeck->isEmpty()) {
         return;
     }
 
-    int baseStack = 0;                              // Start at stack 0, go one heigher each iteration:
-    Card *card{nullptr};
-
-    // Deal the cards onto the tableau
-    for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
-        mPlayStacks[i]->setTopFlipped(false);
-        for (int j = baseStack; j < NUM_PLAY_STACKS; ++j) {
-            card = mDeck->deal();
-            mPlayStacks[j]->addCard(card, false);
-            if (i < j) {
-                card->setFaceUp(false);
-           }
-        }
-        baseStack++;
-    }
-
-    // Move the remaining cards to the hand
-    while (! mDeck->isEmpty()) {
-        card = mDeck->deal();
-        card->setFaceUp(false);
-        mHand->addCard(card, mHand->isTopFlipped());
+    // The model deals the cards, the scene follows
+    CardId order[NUM_CARDS];
+    int count{0};
+    while (!mDeck->isEmpty() && count < NUM_CARDS) {
+        order[count++] = mDeck->deal()->cardId();
     }
-
-    // Flip the top card over and put it on the waste pile
-    card = mHand->takeTop();
-    card->setFaceUp(true);
-    mWastePile->addCard(card, false);
-
+    mState.deal(order);
+    syncScene();
 }
 
 void Game::onNewGameAction(bool checked) {
@@ -483,60 +728,137 @@ void Game::onNewGameAction(bool checked) {
 
 void Game::onNewGameClicked()
 {
-    qDebug() << __func__;
-
-    Card *card{nullptr};
-
-    // Recover cards on the hand
-    while (!mHand->isEmpty()) {
-        card = mHand->takeTop();
-        mDeck->addCard(card, false);
-        card->setFaceUp(true);
-    }
-
-    // Recover cards on the Waste Pile
-    while (!mWastePile->isEmpty()) {
-        card = mWastePile->takeTop();
-        mDeck->addCard(card, false);
-        card->setFaceUp(true);
-    }
+    qCDebug(lcGame) << __func__;
+    newGame(QRandomGenerator::global()->generate());
+}
 
-    // Recover the Foundation (Sorted Stacks)
-    SortedStack *sStack{nullptr};
+/**
+ * @brief newGame - collect, shuffle and deal numbered game gameNumber in one step
+ *
+ * The model is dealt at once and every stack takes its cards straight away, so the new
+ * game can be played immediately.  Only the card items follow, on one CardAnimator
+ * timeline: all cards fly back to the hand, the deck is riffled, then the cards are dealt
+ * out one at a time.  A click or key press fast-forwards whatever is left of it.
+ */
+void Game::newGame(quint64 gameNumber)
+{
+    CardAnimator *animator = CardAnimator::instance();
+    animator->finishAll();
 
-    for (Suit suit: SuitIterator()) {
-        switch(suit) {
-        case Suit::HEART: sStack = mHearts; break;
-        case Suit::DIAMOND: sStack = mDiamonds; break;
-        case Suit::CLUB:   sStack = mClubs; break;
-        case Suit::SPADE:  sStack = mSpades; break;
-        }
-        while (!sStack->isEmpty()) {
-           card = sStack->takeTop();
-           mDeck->addCard(card, false);
-           card->setFaceUp(true);
-        }
+    // Where each card is shown now, the animation starts from there
+    QPointF shownAt[NUM_CARDS];
+    for (int id = 0; id < NUM_CARDS; ++id) {
+        shownAt[id] = mCardItems[id]->scenePos();
     }
 
-    // Recover cards on the tableau
-    for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
-        while (!mPlayStacks[i]->isEmpty()) {
-           card = mPlayStacks[i]->takeTop();
-           mDeck->addCard(card, false);
-           card->setFaceUp(true);
-        }
+    while (!mDeck->isEmpty()) {
+        mDeck->deal();
     }
-
     mHand->newGame();
     mWastePile->newGame();
     mHearts->newGame();
     mDiamonds->newGame();
     mSpades->newGame();
     mClubs->newGame();
-    for (int i =0; i < NUM_PLAY_STACKS; ++i) {
+    for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
         mPlayStacks[i]->newGame();
     }
-    mUndoStack->setClean();
+
+    CardId order[NUM_CARDS];
+    shuffledDeck(gameNumber, order);
+    mState.deal(order);
+    mUndoStack->clear();
+    syncScene();
+
+    mGameNumber = gameNumber;
+    emit gameNumberChanged(gameNumber);
+
+    // Collect: every card flies back to the hand, in shuffled order, face down
+    const QPointF handAt = mHand->scenePos();
+    const int collectEnd = (NUM_CARDS - 1) * COLLECT_STAGGER_MS + COLLECT_DURATION_MS;
+    for (int k = 0; k < NUM_CARDS; ++k) {
+        Card *card = mCardItems[order[k]];
+        QGraphicsItem *stack = card->parentItem();
+        const QPointF home = stack->mapFromScene(handAt);
+        const int delay = k * COLLECT_STAGGER_MS;
+
+        card->setFaceUp(false);
+        card->setVisible(true);
+        card->setPos(stack->mapFromScene(shownAt[order[k]]));
+        animator->moveTo(card, home, COLLECT_DURATION_MS, QEasingCurve::InOutQuad, delay);
+
+        // Shuffle: a riffle that splits the deck to either side and back, all cards together
+        const QPointF split((k % 2) ? CARD_WIDTH/2 : -(CARD_WIDTH/2), 0);
+        animator->queueMove(card, home + split, FLOURISH_DURATION_MS, QEasingCurve::OutQuad,
+                            collectEnd - delay - COLLECT_DURATION_MS);
+        animator->queueMove(card, home, FLOURISH_DURATION_MS, QEasingCurve::InQuad);
+    }
+
+    // Columns that paint their own cards leave the flying ones to their items until syncScene()
+    for (DescendingStack *stack : mPlayStacks) {
+        stack->update();
+    }
+
+    // Deal: the cards that leave the hand go one at a time, in the order GameState::deal() uses
+    int dealt{0};
+    for (int k = 0; k < NUM_CARDS; ++k) {
+        Card *card = mCardItems[order[k]];
+        CardStack *stack = static_cast<CardStack*>(card->parentItem());
+        const int index = stack->cards().indexOf(card);
+        if (stack == mHand) {
+            continue;
+        }
+        animator->queueMove(card, stack->cardPos(index), DEAL_DURATION_MS, QEasingCurve::OutCubic,
+                            dealt++ * DEAL_STAGGER_MS);
+    }
+
+    // Turn the cards up once they have all landed
+    animator->whenFinished(this, [this]() { syncScene(); });
+}
+
+/**
+ * @brief setState - play on from a position set up elsewhere, e.g. for a benchmark
+ */
+void Game::setState(const GameState& state)
+{
+    CardAnimator::instance()->finishAll();
+    while (!mDeck->isEmpty()) {
+        mDeck->deal();
+    }
+    mState = state;
+    mUndoStack->clear();
+    syncScene();
+}
+
+/**
+ * @brief toggleTrace - start recording trace spans, or stop and save them for chrome://tracing
+ */
+void Game::toggleTrace()
+{
+    if (!Trace::isEnabled()) {
+        Trace::clear();
+        Trace::setEnabled(true);
+        qCInfo(lcGame) << "Tracing, press F4 again to save the trace";
+        return;
+    }
+    Trace::setEnabled(false);
+    const QString path = QDir(QDir::tempPath()).filePath(
+        QString("solitaire-trace-%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss")));
+    if (Trace::dump(QFile::encodeName(path).constData())) {
+        qCInfo(lcGame) << "Trace saved to" << path;
+    } else {
+        qWarning() << "Cannot write trace" << path;
+    }
+}
+
+/**
+ * @brief setColumnRendering - paint each tableau column as one cached item, see DescendingStack
+ */
+void Game::setColumnRendering(bool columnRendering)
+{
+    for (DescendingStack *stack : mPlayStacks) {
+        stack->setColumnMode(columnRendering);
+    }
 }
 
 void Game::onExitAction(bool checked) {
@@ -546,7 +868,7 @@ void Game::onExitAction(bool checked) {
 
 void Game::onExitClicked()
 {
-    qDebug() << __func__;
+    qCDebug(lcGame) << __func__;
 
     // https://doc.qt.io/qt-6/qmessagebox.html
     QMessageBox* msgBox = new QMessageBox(this);
@@ -562,7 +884,7 @@ void Game::onExitClicked()
         QApplication::exit(0);
         break;
     case QMessageBox::No:
-        qDebug() << "Exit Canceled";
+        qCDebug(lcGame) << "Exit Canceled";
         break;
     default:
         // should never be reached
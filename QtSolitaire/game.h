@@ -4,6 +4,8 @@
 #include "card.h"
 #include "cardstack.h"
 #include "constants.h"
+#include "gamestate.h"
+#include "moves.h"
 
 #include <QGraphicsView>
 #include <QSharedPointer>
@@ -15,9 +17,12 @@ class DescendingStack;
 class RandomStack;
 class SortedStack;
 class Deck;
+class DragController;
 class myScene;
+class PerfHud;
 
 QT_FORWARD_DECLARE_CLASS(QMenuBar);
+QT_FORWARD_DECLARE_CLASS(QGraphicsRectItem);
 
 class Game : public QGraphicsView
 {
@@ -34,8 +39,26 @@ public:
     void createActions(myScene *scene);
     void createMenus();
 
+    const GameState& state() const { return mState; }
+    CardStack* stackFor(Pile pile) const;
+    void pushMove(const Move& move);
+
+    quint64 gameNumber() const { return mGameNumber; }
+    void shuffle(quint64 gameNumber);
+    void newGame(quint64 gameNumber);
+    void setColumnRendering(bool columnRendering);
+    void setState(const GameState& state);
+    PerfHud* perfHud() const { return mHud; }
+
+signals:
+    void gameNumberChanged(quint64 gameNumber);
+
 protected:
     void showEvent(QShowEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void drawForeground(QPainter *painter, const QRectF& rect) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
 
 private slots:
     void onUndoClicked();
@@ -60,7 +83,27 @@ private slots:
     void onExitAction(bool checked=false);
 
 private:
+    void syncScene();
+    void moveCursor(int dx, int dy);
+    void playAtCursor();
+    void showKeyboardCursor();
+    void hideKeyboardCursor();
+    void toggleTrace();
+
+    GameState mState;                   ///< The game being played, the scene mirrors it
+    Card *mCardItems[NUM_CARDS];        ///< Scene item for each CardId
+    quint64 mGameNumber;                ///< Seed of the last shuffle, see shuffledDeck()
+
     myScene *mScene;
+    DragController *mDragController;
+    PerfHud *mHud;                      ///< Performance overlay, toggled with F3
+
+    // Keyboard play
+    QGraphicsRectItem *mCursorItem;     ///< Outline of the pile under the keyboard cursor
+    QGraphicsRectItem *mSelectionItem;  ///< Outline of the pile picked up with the keyboard
+    int mCursorColumn;                  ///< TableLayout column of the cursor
+    bool mCursorTableau;                ///< Cursor is on the tableau row, else the top row
+    Pile mSelected;                     ///< Pile picked up, or NUM_PILES
     Deck *mDeck;
     RandomStack *mHand;
     RandomStack *mWastePile;
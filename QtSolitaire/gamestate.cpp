@@ -0,0 +1,175 @@
+#include "gamestate.h"
+#include "zobrist.h"
+
+#include <cstring>
+
+/******************************************************************************
+ * GameState Implementation
+ *****************************************************************************/
+/**
+ * @brief clear - remove every card, as when the cards are all back in the Deck
+ */
+void GameState::clear()
+{
+    std::memset(mTalon, NO_CARD, sizeof(mTalon));
+    std::memset(mColumns, NO_CARD, sizeof(mColumns));
+    mTalonSize = 0;
+    mWasteSize = 0;
+    std::memset(mFoundationSize, 0, sizeof(mFoundationSize));
+    std::memset(mColumnSize, 0, sizeof(mColumnSize));
+    std::memset(mColumnDown, 0, sizeof(mColumnDown));
+    mFaceUp = 0;
+    mHash = computeHash();
+}
+
+/**
+ * @brief deal lays out a shuffled deck exactly the way Game::onDealClicked always has
+ *
+ * Cards are dealt one row at a time, each row starting one column further right, with
+ * only the last card of each column face up.  The remaining cards go face down on the
+ * hand, and the top of the hand is turned over onto the waste pile.
+ *
+ * @param order deck order, order[0] is the first card dealt
+ */
+void GameState::deal(const CardId order[NUM_CARDS])
+{
+    clear();
+
+    int next{0};
+    for (int i = 0; i < NUM_PLAY_STACKS; ++i) {
+        for (int j = i; j < NUM_PLAY_STACKS; ++j) {
+            CardId card = order[next++];
+            mColumns[j][mColumnSize[j]++] = card;
+            if (i == j) {
+                mFaceUp |= uint64_t{1} << card;
+            }
+        }
+    }
+    for (int j = 0; j < NUM_PLAY_STACKS; ++j) {
+        mColumnDown[j] = static_cast<uint8_t>(j);
+    }
+
+    // The hand is built bottom to top from the rest of the deck, so the last card
+    // dealt ends up on top, and is then flipped onto the waste pile.
+    mTalonSize = static_cast<uint8_t>(NUM_CARDS - next);
+    for (int k = 0; k < mTalonSize; ++k) {
+        mTalon[k] = order[NUM_CARDS - 1 - k];
+    }
+    mWasteSize = 1;
+    mFaceUp |= uint64_t{1} << mTalon[0];
+    mHash = computeHash();
+}
+
+/**
+ * @brief setPile replaces the contents of one pile
+ *
+ * Used to load a position that was not produced by deal(), e.g. when capturing the
+ * layout of the scene.  For the hand every card is face down, for the waste pile and
+ * foundations every card is face up, so faceDownCount only matters for the tableau.
+ *
+ * @param pile pile to replace
+ * @param cards cards bottom to top
+ * @param count number of cards
+ * @param faceDownCount number of face down cards at the bottom of a tableau column
+ */
+void GameState::setPile(Pile pile, const CardId *cards, int count, int faceDownCount)
+{
+    // Remove the old contents from the face up mask
+    for (int i = 0; i < pileSize(pile); ++i) {
+        mFaceUp &= ~(uint64_t{1} << cardAt(pile, i));
+    }
+
+    if (pile == PILE_HAND) {
+        mTalonSize = static_cast<uint8_t>(mWasteSize + count);
+        for (int k = 0; k < count; ++k) {
+            mTalon[mWasteSize + k] = cards[count - 1 - k];
+        }
+    } else if (pile == PILE_WASTE) {
+        int handSize = mTalonSize - mWasteSize;
+        std::memmove(&mTalon[count], &mTalon[mWasteSize], handSize);
+        std::memcpy(mTalon, cards, count);
+        mWasteSize = static_cast<uint8_t>(count);
+        mTalonSize = static_cast<uint8_t>(count + handSize);
+        for (int k = 0; k < count; ++k) {
+            mFaceUp |= uint64_t{1} << cards[k];
+        }
+    } else if (pile < PILE_TABLEAU) {
+        mFoundationSize[pile - PILE_FOUNDATION] = static_cast<uint8_t>(count);
+        for (int k = 0; k < count; ++k) {
+            mFaceUp |= uint64_t{1} << cardAt(pile, k);
+        }
+    } else {
+        int column = pile - PILE_TABLEAU;
+        std::memcpy(mColumns[column], cards, count);
+        mColumnSize[column] = static_cast<uint8_t>(count);
+        mColumnDown[column] = static_cast<uint8_t>(faceDownCount);
+        for (int k = faceDownCount; k < count; ++k) {
+            mFaceUp |= uint64_t{1} << cards[k];
+        }
+    }
+    mHash = computeHash();
+}
+
+/**
+ * @brief computeHash - Zobrist hash of the position, computed from scratch
+ *
+ * makeMove/unmakeMove keep mHash equal to this without recomputing it.
+ */
+uint64_t GameState::computeHash() const
+{
+    uint64_t hash = ZOBRIST.wasteSize[mWasteSize];
+    for (int k = 0; k < mTalonSize; ++k) {
+        hash ^= ZOBRIST.talon[k][mTalon[k]];
+    }
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        hash ^= ZOBRIST.foundation[s][mFoundationSize[s]];
+    }
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        for (int d = 0; d < mColumnSize[c]; ++d) {
+            hash ^= ZOBRIST.tableau[c][d][mColumns[c][d]][d >= mColumnDown[c]];
+        }
+    }
+    return hash;
+}
+
+int GameState::cardCount() const
+{
+    int count = mTalonSize;
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        count += mFoundationSize[s];
+    }
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        count += mColumnSize[c];
+    }
+    return count;
+}
+
+bool GameState::isWon() const
+{
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        if (mFoundationSize[s] != CARDS_PER_SUIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief operator == compares positions, ignoring unused slots in the fixed arrays
+ */
+bool GameState::operator==(const GameState& other) const
+{
+    if (mHash != other.mHash || mTalonSize != other.mTalonSize || mWasteSize != other.mWasteSize || mFaceUp != other.mFaceUp ||
+        std::memcmp(mFoundationSize, other.mFoundationSize, sizeof(mFoundationSize)) != 0 ||
+        std::memcmp(mColumnSize, other.mColumnSize, sizeof(mColumnSize)) != 0 ||
+        std::memcmp(mColumnDown, other.mColumnDown, sizeof(mColumnDown)) != 0 ||
+        std::memcmp(mTalon, other.mTalon, mTalonSize) != 0) {
+        return false;
+    }
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        if (std::memcmp(mColumns[c], other.mColumns[c], mColumnSize[c]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,130 @@
+#ifndef GAMESTATE_H
+#define GAMESTATE_H
+
+#include "cardtypes.h"
+#include "constants.h"
+
+#include <cstdint>
+
+/**
+ * @brief Pile numbers for the thirteen places a card can live once the game is dealt.
+ *
+ * This is a plain (unscoped) enum on purpose: the engine indexes arrays with it and
+ * steps through the foundations and tableau columns arithmetically.
+ */
+enum Pile : uint8_t {
+    PILE_HAND,                                          ///< Face down "stock" the player draws from
+    PILE_WASTE,                                         ///< Face up cards drawn from the hand
+    PILE_FOUNDATION,                                    ///< First of four foundations, in Suit order
+    PILE_TABLEAU = PILE_FOUNDATION + NUM_SUITS,         ///< First of NUM_PLAY_STACKS tableau columns
+    NUM_PILES = PILE_TABLEAU + NUM_PLAY_STACKS
+};
+
+constexpr Pile foundationPile(Suit s) { return static_cast<Pile>(PILE_FOUNDATION + static_cast<int>(s)); }
+constexpr Pile tableauPile(int column) { return static_cast<Pile>(PILE_TABLEAU + column); }
+constexpr bool isFoundationPile(int p) { return p >= PILE_FOUNDATION && p < PILE_TABLEAU; }
+constexpr bool isTableauPile(int p) { return p >= PILE_TABLEAU && p < NUM_PILES; }
+
+class Move;
+struct UndoInfo;
+
+static const int MAX_TALON{NUM_CARDS - NUM_PLAY_STACKS*(NUM_PLAY_STACKS+1)/2};   ///< Hand + waste = 24 cards
+static const int MAX_COLUMN{NUM_PLAY_STACKS - 1 + CARDS_PER_SUIT};               ///< 6 face down + King..Ace = 19
+
+/**
+ * @brief GameState is a headless, trivially copyable snapshot of a dealt game.
+ *
+ * The scene (Card / CardStack items) mirrors this object, it does not own the game.
+ * The whole position is about 200 bytes, so positions can be copied, compared and
+ * simulated without touching any Qt object.
+ *
+ * Storage:
+ *  - The hand and waste pile share one "talon" array.  mTalon[0..mWasteSize) is the
+ *    waste pile (top at mWasteSize-1), mTalon[mWasteSize..mTalonSize) is the hand (top
+ *    at mWasteSize).  Drawing a card or resetting the hand only moves mWasteSize.
+ *  - Foundations hold Ace..N of one suit, so only their length is stored.
+ *  - Each tableau column stores its cards bottom to top, the lowest mColumnDown of
+ *    them are face down.
+ *  - mFaceUp has one bit per CardId.
+ *  - mHash is the Zobrist hash of the position (see zobrist.h), kept up to date
+ *    incrementally by makeMove/unmakeMove.
+ */
+class GameState
+{
+public:
+    GameState() { clear(); }
+
+    void clear();
+    void deal(const CardId order[NUM_CARDS]);
+    void setPile(Pile pile, const CardId *cards, int count, int faceDownCount);
+
+    inline int pileSize(Pile pile) const;
+    inline CardId cardAt(Pile pile, int index) const;     ///< index 0 is the bottom of the pile
+    CardId top(Pile pile) const {
+        int n = pileSize(pile);
+        return n > 0 ? cardAt(pile, n-1) : NO_CARD;
+    }
+    inline int faceDownCount(Pile pile) const;
+
+    bool isFaceUp(CardId id) const { return (mFaceUp >> id) & 1; }
+    uint64_t faceUpMask() const { return mFaceUp; }
+
+    uint64_t hash() const { return mHash; }
+    uint64_t computeHash() const;
+
+    int cardCount() const;
+    bool isWon() const;
+
+    bool operator==(const GameState& other) const;
+    bool operator!=(const GameState& other) const { return !(*this == other); }
+
+private:
+    template <bool UPDATE_HASH> friend UndoInfo playMove(GameState& state, Move move);
+    friend void unmakeMove(GameState& state, Move move, const UndoInfo& undoInfo);
+
+    CardId mTalon[MAX_TALON];
+    CardId mColumns[NUM_PLAY_STACKS][MAX_COLUMN];
+    uint8_t mTalonSize;
+    uint8_t mWasteSize;
+    uint8_t mFoundationSize[NUM_SUITS];
+    uint8_t mColumnSize[NUM_PLAY_STACKS];
+    uint8_t mColumnDown[NUM_PLAY_STACKS];
+    uint64_t mFaceUp;
+    uint64_t mHash;
+};
+
+int GameState::pileSize(Pile pile) const
+{
+    if (pile == PILE_HAND) {
+        return mTalonSize - mWasteSize;
+    } else if (pile == PILE_WASTE) {
+        return mWasteSize;
+    } else if (pile < PILE_TABLEAU) {
+        return mFoundationSize[pile - PILE_FOUNDATION];
+    }
+    return mColumnSize[pile - PILE_TABLEAU];
+}
+
+CardId GameState::cardAt(Pile pile, int index) const
+{
+    if (pile == PILE_HAND) {
+        return mTalon[mTalonSize - 1 - index];
+    } else if (pile == PILE_WASTE) {
+        return mTalon[index];
+    } else if (pile < PILE_TABLEAU) {
+        return static_cast<CardId>((pile - PILE_FOUNDATION)*CARDS_PER_SUIT + index);
+    }
+    return mColumns[pile - PILE_TABLEAU][index];
+}
+
+int GameState::faceDownCount(Pile pile) const
+{
+    if (pile == PILE_HAND) {
+        return mTalonSize - mWasteSize;
+    } else if (pile < PILE_TABLEAU) {
+        return 0;
+    }
+    return mColumnDown[pile - PILE_TABLEAU];
+}
+
+#endif // GAMESTATE_H
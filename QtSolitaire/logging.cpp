@@ -0,0 +1,108 @@
+#include "logging.h"
+
+#include <QElapsedTimer>
+#include <QFile>
+#include <QMutex>
+
+#include <array>
+#include <cstdio>
+#include <memory>
+
+// Debug messages are off until switched on, see logging.h
+Q_LOGGING_CATEGORY(lcCard, "solitaire.card", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcStack, "solitaire.stack", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcScene, "solitaire.scene", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcDrag, "solitaire.drag", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcUndo, "solitaire.undo", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcGame, "solitaire.game", QtInfoMsg)
+
+namespace {
+
+struct LogRecord {
+    qint64 msecs;                       ///< Since the ring was installed
+    QtMsgType type;
+    const char *category;               ///< Category names are string literals
+    char text[LogRing::TEXT_BYTES];
+};
+
+QMutex sRingLock;                       ///< Guards the ring, messages come from any thread
+std::unique_ptr<std::array<LogRecord, LogRing::RECORDS>> sRecords;
+quint64 sWritten{0};                    ///< Records ever written
+QByteArray sPath;
+QElapsedTimer sClock;
+QtMessageHandler sPrevious{nullptr};
+
+const char* typeName(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg:    return "debug";
+    case QtInfoMsg:     return "info";
+    case QtWarningMsg:  return "warning";
+    case QtCriticalMsg: return "critical";
+    case QtFatalMsg:    return "fatal";
+    }
+    return "?";
+}
+
+void ringHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    {
+        QMutexLocker lock(&sRingLock);
+        LogRecord& record = (*sRecords)[sWritten % LogRing::RECORDS];
+        record.msecs = sClock.elapsed();
+        record.type = type;
+        record.category = context.category ? context.category : "default";
+        qstrncpy(record.text, message.toUtf8().constData(), sizeof(record.text));
+        sWritten++;
+    }
+    if (type == QtFatalMsg) {
+        LogRing::dump();
+    }
+    if (type != QtDebugMsg && sPrevious) {
+        sPrevious(type, context, message);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief install - start keeping messages, to be dumped to path
+ *
+ * Call once, early in main().
+ */
+void LogRing::install(const QString& path)
+{
+    if (sRecords) {
+        return;
+    }
+    sRecords = std::make_unique<std::array<LogRecord, RECORDS>>();
+    sPath = QFile::encodeName(path);
+    sClock.start();
+    QLoggingCategory::setFilterRules("solitaire.*.debug=true");
+    sPrevious = qInstallMessageHandler(ringHandler);
+}
+
+/**
+ * @brief dump - write the kept messages to the install() path as text, oldest first
+ *
+ * @return false if the ring is not installed or the file could not be written
+ */
+bool LogRing::dump()
+{
+    if (!sRecords) {
+        return false;
+    }
+    FILE *file = std::fopen(sPath.constData(), "w");
+    if (!file) {
+        return false;
+    }
+
+    QMutexLocker lock(&sRingLock);
+    const quint64 begin = sWritten > quint64(RECORDS) ? sWritten - RECORDS : 0;
+    for (quint64 n = begin; n < sWritten; ++n) {
+        const LogRecord& record = (*sRecords)[n % RECORDS];
+        std::fprintf(file, "%10.3f %-8s %s: %s\n",
+                     record.msecs / 1e3, typeName(record.type), record.category, record.text);
+    }
+    return std::fclose(file) == 0;
+}
@@ -0,0 +1,42 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <QString>
+
+/*
+ * The game's logging categories, all named solitaire.*.  Their debug messages are off
+ * unless switched on, e.g. QT_LOGGING_RULES="solitaire.undo.debug=true".  A disabled
+ * qCDebug() costs one branch and does not evaluate or format its arguments; release
+ * builds define QT_NO_DEBUG_OUTPUT, which compiles qCDebug() out altogether.
+ */
+Q_DECLARE_LOGGING_CATEGORY(lcCard)
+Q_DECLARE_LOGGING_CATEGORY(lcStack)
+Q_DECLARE_LOGGING_CATEGORY(lcScene)
+Q_DECLARE_LOGGING_CATEGORY(lcDrag)
+Q_DECLARE_LOGGING_CATEGORY(lcUndo)
+Q_DECLARE_LOGGING_CATEGORY(lcGame)
+
+/**
+ * @brief The LogRing class keeps the latest log messages in memory for a post-mortem dump
+ *
+ * Once installed it switches on the solitaire.* debug messages and stores every message
+ * as a fixed size record in a ring of RECORDS, cutting texts at TEXT_BYTES.  Debug
+ * messages only go to the ring, the rest still reach the console.  Release builds have
+ * no qCDebug() messages to keep (QT_NO_DEBUG_OUTPUT), so there the ring holds info,
+ * warning and critical messages only.  dump() writes the ring to the file given to
+ * install(), oldest first; a fatal message dumps it before the program aborts.
+ */
+class LogRing
+{
+public:
+    LogRing() = delete;
+
+    static void install(const QString& path);
+    static bool dump();
+
+    static const int RECORDS{2048};
+    static const int TEXT_BYTES{112};         ///< Including the terminating nul
+};
+
+#endif // LOGGING_H
@@ -1,13 +1,73 @@
 #include "mainwindow.h"
+#include "game.h"
+#include "logging.h"
+#include "perfhud.h"
+#include "trace.h"
 
 #include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QFile>
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
+    Trace::setThreadName("GUI");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QApplication::translate("main", "Klondike Solitaire"));
+    parser.addHelpOption();
+    QCommandLineOption gameOption({"g", "game"},
+                                  QApplication::translate("main", "Start game number <number>."),
+                                  QApplication::translate("main", "number"));
+    parser.addOption(gameOption);
+    QCommandLineOption columnOption("column-render",
+                                    QApplication::translate("main", "Paint each tableau column as a single item."));
+    parser.addOption(columnOption);
+    QCommandLineOption hudOption("hud", QApplication::translate("main", "Show the performance overlay (F3)."));
+    parser.addOption(hudOption);
+    QCommandLineOption traceOption("trace",
+                                   QApplication::translate("main", "Record a trace from the start and save it to <file> on exit."),
+                                   QApplication::translate("main", "file"));
+    parser.addOption(traceOption);
+    QCommandLineOption logRingOption("log-ring",
+                                     QApplication::translate("main", "Keep recent log messages, with debug messages in debug builds, and save them to <file> on exit or a fatal error."),
+                                     QApplication::translate("main", "file"));
+    parser.addOption(logRingOption);
+    parser.process(app);
+    if (parser.isSet(traceOption)) {
+        Trace::setEnabled(true);
+    }
+    if (parser.isSet(logRingOption)) {
+        LogRing::install(parser.value(logRingOption));
+    }
 
     MainWindow w;
     w.show();
 
-    return app.exec();
+    if (parser.isSet(columnOption)) {
+        w.game()->setColumnRendering(true);
+    }
+    if (parser.isSet(hudOption)) {
+        w.game()->perfHud()->setVisible(true);
+    }
+
+    if (parser.isSet(gameOption)) {
+        bool ok{false};
+        quint64 gameNumber = parser.value(gameOption).toULongLong(&ok);
+        if (ok) {
+            w.game()->newGame(gameNumber);
+        } else {
+            qWarning() << "Invalid game number" << parser.value(gameOption);
+        }
+    }
+
+    int result = app.exec();
+    if (parser.isSet(traceOption) && !Trace::dump(QFile::encodeName(parser.value(traceOption)).constData())) {
+        qWarning() << "Cannot write trace" << parser.value(traceOption);
+    }
+    if (parser.isSet(logRingOption) && !LogRing::dump()) {
+        qWarning() << "Cannot write log" << parser.value(logRingOption);
+    }
+    return result;
 }
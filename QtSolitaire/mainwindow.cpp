@@ -2,6 +2,7 @@
 #include "./ui_mainwindow.h"
 
 #include "game.h"
+#include "logging.h"
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -9,11 +10,11 @@ MainWindow::MainWindow(QWidget *parent)
 {
     ui->setupUi(this);
 
-    qDebug() << "Hello";
+    qCDebug(lcGame) << "Main window created";
 
     // Game is automatically shown by the framework.
     mGame = new Game{ui->centralwidget, ui->menubar};
-
+    connect(mGame, &Game::gameNumberChanged, this, &MainWindow::onGameNumberChanged);
 }
 
 MainWindow::~MainWindow()
@@ -21,3 +22,11 @@ MainWindow::~MainWindow()
     delete ui;
 }
 
+
+/**
+ * @brief onGameNumberChanged show the number of the game being played, so it can be shared
+ */
+void MainWindow::onGameNumberChanged(quint64 gameNumber)
+{
+    setWindowTitle(tr("QtSolitaire - Game #%1").arg(gameNumber));
+}
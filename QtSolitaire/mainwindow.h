@@ -16,6 +16,11 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+    Game* game() const { return mGame; }
+
+private slots:
+    void onGameNumberChanged(quint64 gameNumber);
+
 private:
     Ui::MainWindow *ui;
     Game *mGame;
@@ -0,0 +1,300 @@
+#include "moves.h"
+#include "movesdetail.h"
+#include "rules.h"
+#include "zobrist.h"
+
+#include <cstring>
+
+/* Building with SOLITAIRE_CHECK_HASH defined cross-checks the incremental hash against
+ * a full GameState::computeHash() after every makeMove/unmakeMove, in every build type:
+ * a mismatch prints the move and aborts.
+ */
+#ifdef SOLITAIRE_CHECK_HASH
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+
+static void checkHash(const GameState& state, Move move, const char *where)
+{
+    const uint64_t computed = state.computeHash();
+    if (state.hash() != computed) {
+        std::fprintf(stderr, "%s: incremental hash %016" PRIx64 " != computed %016" PRIx64
+                     " after move %d -> %d, %d cards%s\n",
+                     where, state.hash(), computed, move.from(), move.to(), move.count(),
+                     move.flips() ? ", flip" : "");
+        std::abort();
+    }
+}
+#define CHECK_HASH(state) checkHash((state), move, __func__)
+#else
+#define CHECK_HASH(state)
+#endif
+
+/**
+ * @brief generateMoves - append every legal move of the position to list
+ *
+ * Moves are emitted grouped by source: waste pile, tableau columns (foundation first,
+ * then other columns, for every face up card), foundations back to the tableau, and
+ * finally drawing from or resetting the hand.  Nothing is allocated.
+ *
+ * @return number of moves in list
+ */
+int generateMoves(const GameState& state, MoveList& list)
+{
+    list.clear();
+
+    // For every card, the set of tableau columns that would accept it.  The accept masks
+    // of non-empty columns have at most two bits, empty columns take the four Kings.
+    uint8_t columnsAccepting[NUM_CARDS] = {};
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        uint64_t mask = acceptMask(state, tableauPile(c));
+        while (mask) {
+            int card = lowestBit(mask);
+            columnsAccepting[card] |= static_cast<uint8_t>(1 << c);
+            mask &= mask - 1;
+        }
+    }
+
+    auto foundationAccepts = [&state](CardId card) {
+        return state.pileSize(foundationPile(cardSuit(card))) == cardRank(card) - 1;
+    };
+
+    auto addTableauMoves = [&list, &columnsAccepting](Pile from, CardId card, int count, bool flip) {
+        unsigned columns = columnsAccepting[card];
+        if (isTableauPile(from)) {
+            columns &= ~(1u << (from - PILE_TABLEAU));
+        }
+        while (columns) {
+            int c = lowestBit(columns);
+            list.add(Move(from, tableauPile(c), count, flip));
+            columns &= columns - 1;
+        }
+    };
+
+    // Waste pile top
+    CardId wasteTop = state.top(PILE_WASTE);
+    if (wasteTop != NO_CARD) {
+        if (foundationAccepts(wasteTop)) {
+            list.add(Move(PILE_WASTE, foundationPile(cardSuit(wasteTop)), 1));
+        }
+        addTableauMoves(PILE_WASTE, wasteTop, 1, false);
+    }
+
+    // Tableau: the top card may go to its foundation, any face up card may take the
+    // cards above it to another column.
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        Pile from = tableauPile(c);
+        int size = state.pileSize(from);
+        if (size == 0) {
+            continue;
+        }
+        int down = state.faceDownCount(from);
+        CardId top = state.cardAt(from, size - 1);
+        if (foundationAccepts(top)) {
+            list.add(Move(from, foundationPile(cardSuit(top)), 1, down > 0 && down == size - 1));
+        }
+        for (int i = down; i < size; ++i) {
+            addTableauMoves(from, state.cardAt(from, i), size - i, i == down && down > 0);
+        }
+    }
+
+    // Foundation tops back to the tableau
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        Pile from = static_cast<Pile>(PILE_FOUNDATION + s);
+        CardId top = state.top(from);
+        if (top != NO_CARD) {
+            addTableauMoves(from, top, 1, false);
+        }
+    }
+
+    // Hand
+    if (state.pileSize(PILE_HAND) > 0) {
+        list.add(Move(PILE_HAND, PILE_WASTE, 1));
+    } else if (state.pileSize(PILE_WASTE) > 0) {
+        list.add(Move(PILE_WASTE, PILE_HAND, state.pileSize(PILE_WASTE)));
+    }
+
+    return list.size;
+}
+
+/**
+ * @brief playMove - makeMove, with or without the incremental hash update
+ *
+ * Without it the XORs are dead code the compiler drops, which is how the engine bench
+ * isolates their cost.
+ */
+template <bool UPDATE_HASH>
+UndoInfo playMove(GameState& state, Move move)
+{
+    UndoInfo undoInfo;
+    const Pile from = move.from();
+    const Pile to = move.to();
+    const int count = move.count();
+    uint64_t hash = state.mHash;
+
+    undoInfo.hash = hash;
+
+    // Drawing and resetting the hand only move the boundary between hand and waste
+    if (from == PILE_HAND || to == PILE_HAND) {
+        int w = state.mWasteSize;
+        if (from == PILE_HAND) {
+            state.mFaceUp |= cardBit(state.mTalon[w]);
+            state.mWasteSize++;
+        } else {
+            for (int k = 0; k < w; ++k) {
+                state.mFaceUp &= ~cardBit(state.mTalon[k]);
+            }
+            state.mWasteSize = 0;
+        }
+        if (UPDATE_HASH) {
+            state.mHash = hash ^ ZOBRIST.wasteSize[w] ^ ZOBRIST.wasteSize[state.mWasteSize];
+            CHECK_HASH(state);
+        }
+        return undoInfo;
+    }
+
+    // Take the cards from the source
+    CardId single{NO_CARD};
+    const CardId *cards{&single};
+    if (from == PILE_WASTE) {
+        // Every card above the waste top slides down one slot in the talon
+        int w = state.mWasteSize - 1;
+        int n = state.mTalonSize;
+        for (int k = w; k < n; ++k) {
+            hash ^= ZOBRIST.talon[k][state.mTalon[k]];
+        }
+        single = state.mTalon[w];
+        std::memmove(&state.mTalon[w], &state.mTalon[w + 1], n - w - 1);
+        for (int k = w; k < n - 1; ++k) {
+            hash ^= ZOBRIST.talon[k][state.mTalon[k]];
+        }
+        hash ^= ZOBRIST.wasteSize[w + 1] ^ ZOBRIST.wasteSize[w];
+        state.mTalonSize--;
+        state.mWasteSize--;
+    } else if (isFoundationPile(from)) {
+        int s = from - PILE_FOUNDATION;
+        hash ^= ZOBRIST.foundation[s][state.mFoundationSize[s]];
+        state.mFoundationSize[s]--;
+        hash ^= ZOBRIST.foundation[s][state.mFoundationSize[s]];
+        single = static_cast<CardId>(s*CARDS_PER_SUIT + state.mFoundationSize[s]);
+    } else {
+        int c = from - PILE_TABLEAU;
+        uint8_t size = static_cast<uint8_t>(state.mColumnSize[c] - count);
+        for (int d = size; d < state.mColumnSize[c]; ++d) {
+            hash ^= ZOBRIST.tableau[c][d][state.mColumns[c][d]][1];
+        }
+        state.mColumnSize[c] = size;
+        cards = &state.mColumns[c][size];
+        if (size > 0 && state.mColumnDown[c] == size) {
+            CardId flipped = state.mColumns[c][size - 1];
+            hash ^= ZOBRIST.tableau[c][size - 1][flipped][0] ^ ZOBRIST.tableau[c][size - 1][flipped][1];
+            state.mColumnDown[c]--;
+            state.mFaceUp |= cardBit(flipped);
+            undoInfo.topFlipped = true;
+        }
+    }
+
+    // And put them on the destination
+    if (isFoundationPile(to)) {
+        int s = to - PILE_FOUNDATION;
+        hash ^= ZOBRIST.foundation[s][state.mFoundationSize[s]];
+        state.mFoundationSize[s]++;
+        hash ^= ZOBRIST.foundation[s][state.mFoundationSize[s]];
+    } else {
+        int c = to - PILE_TABLEAU;
+        int size = state.mColumnSize[c];
+        for (int k = 0; k < count; ++k) {
+            state.mColumns[c][size + k] = cards[k];
+            hash ^= ZOBRIST.tableau[c][size + k][cards[k]][1];
+        }
+        state.mColumnSize[c] = static_cast<uint8_t>(size + count);
+    }
+
+    if (UPDATE_HASH) {
+        state.mHash = hash;
+        CHECK_HASH(state);
+    }
+    return undoInfo;
+}
+
+/**
+ * @brief makeMove - play a legal move on the state in place
+ *
+ * The move must be legal (as produced by generateMoves) or the state is corrupted.
+ * Whether a face down card was turned over is worked out here, so moves built by
+ * hand do not need the flip flag set.  Nothing is allocated.
+ *
+ * @return what unmakeMove needs to take the move back
+ */
+UndoInfo makeMove(GameState& state, Move move)
+{
+    return playMove<true>(state, move);
+}
+
+/**
+ * @brief makeMoveWithoutHash - see movesdetail.h
+ */
+UndoInfo detail::makeMoveWithoutHash(GameState& state, Move move)
+{
+    return playMove<false>(state, move);
+}
+
+/**
+ * @brief unmakeMove - take back the last move made with makeMove
+ */
+void unmakeMove(GameState& state, Move move, const UndoInfo& undoInfo)
+{
+    const Pile from = move.from();
+    const Pile to = move.to();
+    const int count = move.count();
+
+    state.mHash = undoInfo.hash;
+
+    if (from == PILE_HAND) {
+        state.mWasteSize--;
+        state.mFaceUp &= ~cardBit(state.mTalon[state.mWasteSize]);
+        CHECK_HASH(state);
+        return;
+    }
+    if (to == PILE_HAND) {
+        state.mWasteSize = static_cast<uint8_t>(count);
+        for (int k = 0; k < count; ++k) {
+            state.mFaceUp |= cardBit(state.mTalon[k]);
+        }
+        CHECK_HASH(state);
+        return;
+    }
+
+    // Take the cards back off the destination
+    CardId single{NO_CARD};
+    const CardId *cards{&single};
+    if (isFoundationPile(to)) {
+        int s = to - PILE_FOUNDATION;
+        state.mFoundationSize[s]--;
+        single = static_cast<CardId>(s*CARDS_PER_SUIT + state.mFoundationSize[s]);
+    } else {
+        int c = to - PILE_TABLEAU;
+        state.mColumnSize[c] = static_cast<uint8_t>(state.mColumnSize[c] - count);
+        cards = &state.mColumns[c][state.mColumnSize[c]];
+    }
+
+    // Return them to the source
+    if (from == PILE_WASTE) {
+        int w = state.mWasteSize;
+        std::memmove(&state.mTalon[w + 1], &state.mTalon[w], state.mTalonSize - w);
+        state.mTalon[w] = cards[0];
+        state.mTalonSize++;
+        state.mWasteSize++;
+    } else if (isFoundationPile(from)) {
+        state.mFoundationSize[from - PILE_FOUNDATION]++;
+    } else {
+        int c = from - PILE_TABLEAU;
+        if (undoInfo.topFlipped) {
+            state.mFaceUp &= ~cardBit(state.mColumns[c][state.mColumnSize[c] - 1]);
+            state.mColumnDown[c]++;
+        }
+        std::memcpy(&state.mColumns[c][state.mColumnSize[c]], cards, count);
+        state.mColumnSize[c] = static_cast<uint8_t>(state.mColumnSize[c] + count);
+    }
+    CHECK_HASH(state);
+}
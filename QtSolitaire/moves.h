@@ -0,0 +1,88 @@
+#ifndef MOVES_H
+#define MOVES_H
+
+#include "gamestate.h"
+
+#include <cstdint>
+
+/**
+ * @brief Move is a 16 bit record of one legal play
+ *
+ *   bits  0..3   source pile
+ *   bits  4..7   destination pile
+ *   bits  8..12  number of cards moved
+ *   bit   13     the move turns over a face down tableau card
+ *
+ * Drawing from the hand is PILE_HAND -> PILE_WASTE with a count of 1, resetting the
+ * hand is PILE_WASTE -> PILE_HAND with the whole waste pile as the count.
+ * A default constructed Move (all zero bits) is the null move.
+ */
+class Move
+{
+public:
+    constexpr Move() : mBits{0} {}
+    constexpr Move(Pile from, Pile to, int count, bool flip = false)
+        : mBits{static_cast<uint16_t>(from | (to << 4) | (count << 8) | (flip ? FLIP_BIT : 0))}
+    {}
+
+    constexpr Pile from() const { return static_cast<Pile>(mBits & 0x0F); }
+    constexpr Pile to() const { return static_cast<Pile>((mBits >> 4) & 0x0F); }
+    constexpr int count() const { return (mBits >> 8) & 0x1F; }
+    constexpr bool flips() const { return (mBits & FLIP_BIT) != 0; }
+
+    constexpr bool isNull() const { return mBits == 0; }
+    constexpr uint16_t bits() const { return mBits; }
+
+    constexpr bool operator==(const Move& other) const { return mBits == other.mBits; }
+    constexpr bool operator!=(const Move& other) const { return mBits != other.mBits; }
+
+private:
+    static const uint16_t FLIP_BIT{1 << 13};
+    uint16_t mBits;
+};
+
+static const int MAX_MOVES{256};        ///< Comfortably more than any Klondike position allows
+
+/**
+ * @brief MoveList is a fixed size buffer of moves meant to live on the stack
+ */
+struct MoveList {
+    Move moves[MAX_MOVES];
+    int size{0};
+
+    void clear() { size = 0; }
+    void add(Move m) { moves[size++] = m; }
+    const Move* begin() const { return moves; }
+    const Move* end() const { return moves + size; }
+    const Move& operator[](int i) const { return moves[i]; }
+};
+
+int generateMoves(const GameState& state, MoveList& list);
+
+/**
+ * @brief UndoInfo holds what makeMove needs to remember for unmakeMove
+ *
+ * topFlipped plays the part CardStack::isTopFlipped() used to: whether taking the cards
+ * turned over a face down card in the source column.  hash is the position's hash
+ * before the move, which unmakeMove simply puts back.
+ */
+struct UndoInfo {
+    bool topFlipped{false};
+    uint64_t hash{0};
+};
+
+UndoInfo makeMove(GameState& state, Move move);
+void unmakeMove(GameState& state, Move move, const UndoInfo& undoInfo);
+
+/**
+ * @brief movedCard - the bottom card of the group of cards a move picks up
+ */
+inline CardId movedCard(const GameState& state, Move m)
+{
+    if (m.from() == PILE_WASTE && m.to() == PILE_HAND) {
+        return state.cardAt(PILE_WASTE, 0);
+    }
+    return state.cardAt(m.from(), state.pileSize(m.from()) - m.count());
+}
+
+#endif // MOVES_H
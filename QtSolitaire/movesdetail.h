@@ -0,0 +1,22 @@
+#ifndef MOVESDETAIL_H
+#define MOVESDETAIL_H
+
+#include "moves.h"
+
+/*
+ * Engine internals for the engine bench, not part of the moves.h API.
+ */
+namespace detail {
+
+/**
+ * @brief makeMoveWithoutHash - makeMove, but without updating state.hash()
+ *
+ * The hash stays that of the position before the move, so the move must be taken back
+ * with unmakeMove() before anything else reads the state.  Only there to time the hash
+ * update, see solitaire-engine-bench.
+ */
+UndoInfo makeMoveWithoutHash(GameState& state, Move move);
+
+} // namespace detail
+
+#endif // MOVESDETAIL_H
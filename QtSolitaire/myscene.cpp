@@ -0,0 +1,101 @@
+#include "myscene.h"
+#include "card.h"
+#include "cardstack.h"
+#include "logging.h"
+#include "trace.h"
+
+#include <QApplication>
+#include <QDebug>
+#include <QGraphicsSceneMouseEvent>
+#include <QLineF>
+
+myScene::myScene(qreal x, qreal y, qreal width, qreal height, QObject* parent)
+    : QGraphicsScene(x, y, width, height, parent)
+    , mPressedCard{nullptr}
+    , mDragging{false}
+{
+}
+
+/**
+ * @brief cardAt - the topmost visible card at scenePos, or nullptr
+ *
+ * That is a card item, or a card painted by the stack it lies on, see CardStack::paintsCards().
+ */
+Card* myScene::cardAt(const QPointF& scenePos) const
+{
+    for (QGraphicsItem *item : items(scenePos, Qt::IntersectsItemShape, Qt::DescendingOrder)) {
+        if (Card *card = qgraphicsitem_cast<Card*>(item)) {
+            return card;
+        }
+        CardStack *stack = qobject_cast<CardStack*>(item->toGraphicsObject());
+        if (stack && stack->paintsCards()) {
+            if (Card *card = stack->cardAt(stack->mapFromScene(scenePos))) {
+                return card;
+            }
+        }
+    }
+    return nullptr;
+}
+
+void myScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    TRACE_SPAN("event", "myScene::mousePressEvent");
+    qCDebug(lcScene) << "Press at" << event->scenePos();
+    mPressedCard = nullptr;
+    mDragging = false;
+    if (event->button() == Qt::LeftButton) {
+        mPressedCard = cardAt(event->scenePos());
+    }
+    if (mPressedCard) {
+        event->accept();
+        return;
+    }
+    QGraphicsScene::mousePressEvent(event);
+}
+
+void myScene::mouseMoveEvent(QGraphicsSceneMouseEvent *event)
+{
+    TRACE_SPAN("event", "myScene::mouseMoveEvent");
+    if (!mPressedCard || !(event->buttons() & Qt::LeftButton)) {
+        QGraphicsScene::mouseMoveEvent(event);
+        return;
+    }
+    if (!mDragging && QLineF(event->screenPos(), event->buttonDownScreenPos(Qt::LeftButton))
+            .length() < QApplication::startDragDistance()) {
+        return;
+    }
+    mDragging = true;
+    emit cardDragMoved(*mPressedCard, event->scenePos(), event->screenPos());
+}
+
+void myScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    TRACE_SPAN("event", "myScene::mouseReleaseEvent");
+    if (!mPressedCard || event->button() != Qt::LeftButton) {
+        QGraphicsScene::mouseReleaseEvent(event);
+        return;
+    }
+    Card *card = mPressedCard;
+    mPressedCard = nullptr;
+    if (mDragging) {
+        mDragging = false;
+        emit cardDragReleased(*card, event->scenePos());
+    } else {
+        emit cardClicked(*card);
+    }
+}
+
+void myScene::mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event)
+{
+    TRACE_SPAN("event", "myScene::mouseDoubleClickEvent");
+    Card *card = (event->button() == Qt::LeftButton) ? cardAt(event->scenePos()) : nullptr;
+    if (!card) {
+        QGraphicsScene::mouseDoubleClickEvent(event);
+        return;
+    }
+    // The release that follows is not a click
+    mPressedCard = nullptr;
+    mDragging = false;
+    event->accept();
+    emit cardDoubleClicked(*card);
+}
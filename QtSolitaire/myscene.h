@@ -0,0 +1,43 @@
+#ifndef MYSCENE_H
+#define MYSCENE_H
+
+#include <QGraphicsScene>
+#include <QPoint>
+#include <QPointF>
+
+class Card;
+
+/*
+ * The game's scene.  Cards do not take mouse events themselves: the scene finds the
+ * card under a left button press and reports what the pointer does with it as signals,
+ * so card items need no QObject or signal connections of their own.  Presses away
+ * from the cards go to the items below as usual.
+ *
+ * Also shows coordinates from the scene when the left mouse button is pressed, for debugging.
+ */
+class myScene: public QGraphicsScene {
+    Q_OBJECT
+public:
+    myScene() = delete;
+    myScene(qreal x, qreal y, qreal width, qreal height, QObject* parent = nullptr);
+
+    Card* cardAt(const QPointF& scenePos) const;
+
+signals:
+    void cardClicked(Card& card);
+    void cardDoubleClicked(Card& card);
+    void cardDragMoved(Card& card, const QPointF& scenePos, const QPoint& screenPos);
+    void cardDragReleased(Card& card, const QPointF& scenePos);
+
+protected:
+    void mousePressEvent(QGraphicsSceneMouseEvent *event) override;
+    void mouseMoveEvent(QGraphicsSceneMouseEvent *event) override;
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent *event) override;
+    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent *event) override;
+
+private:
+    Card *mPressedCard;         ///< Card under the left button, or nullptr
+    bool mDragging;             ///< mPressedCard moved past the drag distance
+};
+
+#endif // MYSCENE_H
@@ -0,0 +1,357 @@
+#include "parallelsolver.h"
+#include "trace.h"
+
+#include <algorithm>
+
+typedef std::chrono::steady_clock Clock;
+
+static const uint64_t CHECK_INTERVAL{256};
+
+/******************************************************************************
+ * ParallelSolver Implementation
+ *****************************************************************************/
+ParallelSolver::ParallelSolver(int threads, int ttBits)
+    : mTable{ttBits}
+    , mStop{false}
+    , mDepthLimited{false}
+    , mPrune{true}
+    , mPending{0}
+    , mHungry{0}
+    , mNodes{0}
+    , mWon{false}
+    , mGeneration{0}
+    , mRunning{0}
+    , mQuit{false}
+{
+    if (threads <= 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    mSolution.reserve(MAX_DEPTH);
+    for (int i = 0; i < threads; ++i) {
+        mWorkers.emplace_back(new Worker());
+        mWorkers.back()->frames.resize(MAX_DEPTH);
+    }
+    for (int i = 0; i < threads; ++i) {
+        mWorkers[i]->thread = std::thread(&ParallelSolver::threadMain, this, i);
+    }
+}
+
+ParallelSolver::~ParallelSolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(mPoolLock);
+        mQuit = true;
+    }
+    mWake.notify_all();
+    for (std::unique_ptr<Worker>& worker : mWorkers) {
+        worker->thread.join();
+    }
+}
+
+/**
+ * @brief solve - search for a win from start on every thread of the pool
+ *
+ * Like Solver::solve(), a pruned pass runs first and an exhaustive one proves a LOSS.
+ *
+ * @param start position to solve, it is not modified
+ * @param limits node and time budget, nodes are counted over all threads
+ * @return WIN (solution() holds the moves), LOSS, or UNKNOWN if the budget ran out
+ */
+SolveResult ParallelSolver::solve(const GameState& start, const SolverLimits& limits)
+{
+    TRACE_SPAN("engine", "ParallelSolver::solve");
+    mStartTime = Clock::now();
+    mLimits = limits;
+    mStop = false;
+    mDepthLimited = false;
+    mNodes = 0;
+    mWon = false;
+    mSolution.clear();
+    mStats = SolverStats();
+
+    SolveResult result{SolveResult::WIN};
+    if (!start.isWon()) {
+        result = runPass(start, true);
+        if (result == SolveResult::LOSS) {
+            result = runPass(start, false);
+        }
+    }
+    mStats.seconds = std::chrono::duration<double>(Clock::now() - mStartTime).count();
+    return result;
+}
+
+/**
+ * @brief runPass - one search of start on every thread of the pool, adding to mStats
+ */
+SolveResult ParallelSolver::runPass(const GameState& start, bool prune)
+{
+    mPrune = prune;
+    mHungry = 0;
+    mStats.passes++;
+    mTable.clear();
+
+    for (std::unique_ptr<Worker>& worker : mWorkers) {
+        worker->tasks.clear();
+        worker->stats = SolverStats();
+    }
+    mWorkers[0]->tasks.push_back(Task{start, {}});
+    mPending = 1;
+
+    // Wake the pool and wait for every thread to run out of work
+    {
+        std::unique_lock<std::mutex> lock(mPoolLock);
+        mRunning = threadCount();
+        mGeneration++;
+        mWake.notify_all();
+        mDone.wait(lock, [this] { return mRunning == 0; });
+    }
+
+    for (std::unique_ptr<Worker>& worker : mWorkers) {
+        mStats.nodes += worker->stats.nodes;
+        mStats.ttProbes += worker->stats.ttProbes;
+        mStats.ttHits += worker->stats.ttHits;
+        mStats.tasks += worker->stats.tasks;
+        mStats.steals += worker->stats.steals;
+        worker->tasks.clear();
+    }
+
+    if (mWon) {
+        return SolveResult::WIN;
+    }
+    return (mStop || mDepthLimited) ? SolveResult::UNKNOWN : SolveResult::LOSS;
+}
+
+void ParallelSolver::threadMain(int index)
+{
+    Trace::setThreadName("solver");
+    uint64_t generation{0};
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mPoolLock);
+            mWake.wait(lock, [this, generation] { return mQuit || mGeneration != generation; });
+            if (mQuit) {
+                return;
+            }
+            generation = mGeneration;
+        }
+
+        work(index);
+
+        std::lock_guard<std::mutex> lock(mPoolLock);
+        if (--mRunning == 0) {
+            mDone.notify_all();
+        }
+    }
+}
+
+/**
+ * @brief work - search tasks until there are none left anywhere, or the search stops
+ */
+void ParallelSolver::work(int index)
+{
+    Worker& self = *mWorkers[index];
+    Task task;
+    bool hungry{false};
+
+    while (!mStop.load(std::memory_order_relaxed)) {
+        if (takeTask(index, task)) {
+            if (hungry) {
+                mHungry.fetch_sub(1, std::memory_order_relaxed);
+                hungry = false;
+            }
+            search(self, task);
+            mPending.fetch_sub(1, std::memory_order_acq_rel);
+        } else if (mPending.load(std::memory_order_acquire) == 0) {
+            break;
+        } else {
+            if (!hungry) {
+                mHungry.fetch_add(1, std::memory_order_relaxed);
+                hungry = true;
+            }
+            std::this_thread::yield();
+        }
+    }
+    if (hungry) {
+        mHungry.fetch_sub(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief takeTask - newest task of our own deque, else steal the oldest from another thread
+ */
+bool ParallelSolver::takeTask(int index, Task& task)
+{
+    Worker& self = *mWorkers[index];
+    {
+        std::lock_guard<std::mutex> lock(self.lock);
+        if (!self.tasks.empty()) {
+            task = std::move(self.tasks.back());
+            self.tasks.pop_back();
+            return true;
+        }
+    }
+
+    const int count = threadCount();
+    for (int i = 1; i < count; ++i) {
+        Worker& victim = *mWorkers[(index + i) % count];
+        std::lock_guard<std::mutex> lock(victim.lock);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            self.stats.steals++;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief outOfBudget - add this thread's nodes to the shared count and check the limits
+ */
+bool ParallelSolver::outOfBudget()
+{
+    uint64_t nodes = mNodes.fetch_add(CHECK_INTERVAL, std::memory_order_relaxed) + CHECK_INTERVAL;
+    if (mLimits.maxNodes && nodes >= mLimits.maxNodes) {
+        return true;
+    }
+    return mLimits.maxSeconds > 0.0 &&
+           std::chrono::duration<double>(Clock::now() - mStartTime).count() >= mLimits.maxSeconds;
+}
+
+/**
+ * @brief search - depth first search of one task, the same loop as Solver::solve
+ */
+void ParallelSolver::search(Worker& self, Task& task)
+{
+    TRACE_SPAN("engine", "ParallelSolver::search");
+    GameState& state = task.state;
+    std::vector<Frame>& frames = self.frames;
+    const int base = static_cast<int>(task.path.size());
+
+    self.stats.tasks++;
+    if (state.isWon()) {
+        // A donated move that finished the game
+        foundWin(self, task, 0);
+        return;
+    }
+    self.stats.ttProbes++;
+    if (mTable.insert(state.hash())) {
+        self.stats.ttHits++;
+        return;
+    }
+
+    int depth{0};
+    Solver::orderMoves(state, frames[0].moves, mPrune);
+    frames[0].next = 0;
+
+    while (depth >= 0) {
+        Frame& frame = frames[depth];
+        if (frame.next == frame.moves.size) {
+            depth--;
+            if (depth >= 0) {
+                unmakeMove(state, frames[depth].played, frames[depth].undoInfo);
+            }
+            continue;
+        }
+
+        const Move m = frame.moves[frame.next++];
+        frame.played = m;
+        frame.undoInfo = makeMove(state, m);
+        self.stats.nodes++;
+
+        if (state.isWon()) {
+            foundWin(self, task, depth + 1);
+            return;
+        }
+
+        if ((self.stats.nodes % CHECK_INTERVAL) == 0) {
+            if (mStop.load(std::memory_order_relaxed)) {
+                return;
+            }
+            if (outOfBudget()) {
+                mStop = true;
+                return;
+            }
+        }
+
+        self.stats.ttProbes++;
+        if (mTable.insert(state.hash())) {
+            self.stats.ttHits++;
+            unmakeMove(state, m, frame.undoInfo);
+            continue;
+        }
+
+        if (base + depth + 1 >= MAX_DEPTH) {
+            mDepthLimited = true;
+            unmakeMove(state, m, frame.undoInfo);
+            continue;
+        }
+
+        depth++;
+        Solver::orderMoves(state, frames[depth].moves, mPrune);
+        frames[depth].next = 0;
+
+        if (mHungry.load(std::memory_order_relaxed) > 0) {
+            donate(self, task, state, depth);
+        }
+    }
+}
+
+/**
+ * @brief foundWin - record the first win found and stop every thread
+ *
+ * @param depth number of frames played on top of task.path
+ */
+void ParallelSolver::foundWin(const Worker& self, const Task& task, int depth)
+{
+    std::lock_guard<std::mutex> lock(mSolutionLock);
+    if (!mWon) {
+        mWon = true;
+        mSolution = task.path;
+        for (int d = 0; d < depth; ++d) {
+            mSolution.push_back(self.frames[d].played);
+        }
+    }
+    mStop = true;
+}
+
+/**
+ * @brief donate - queue the unsearched moves of the shallowest open frame as new tasks
+ *
+ * @param state position at frames[depth], it is not modified
+ */
+void ParallelSolver::donate(Worker& self, const Task& task, const GameState& state, int depth)
+{
+    std::vector<Frame>& frames = self.frames;
+    int k{0};
+    while (k <= depth && frames[k].next >= frames[k].moves.size) {
+        k++;
+    }
+    if (k > depth) {
+        return;
+    }
+
+    // Walk back up to the position at frames[k]
+    GameState parent = state;
+    for (int d = depth - 1; d >= k; --d) {
+        unmakeMove(parent, frames[d].played, frames[d].undoInfo);
+    }
+
+    std::vector<Move> path = task.path;
+    for (int d = 0; d < k; ++d) {
+        path.push_back(frames[d].played);
+    }
+
+    Frame& frame = frames[k];
+    const int count = frame.moves.size - frame.next;
+    mPending.fetch_add(count, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(self.lock);
+    for (int i = frame.next; i < frame.moves.size; ++i) {
+        Task child{parent, path};
+        makeMove(child.state, frame.moves[i]);
+        child.path.push_back(frame.moves[i]);
+        self.tasks.push_back(std::move(child));
+    }
+    frame.next = frame.moves.size;
+}
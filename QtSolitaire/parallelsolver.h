@@ -0,0 +1,100 @@
+#ifndef PARALLELSOLVER_H
+#define PARALLELSOLVER_H
+
+#include "solver.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief ParallelSolver is the Solver search spread over a pool of threads
+ *
+ * The game tree is cut into tasks, each a position plus the moves that led to it.
+ * Every thread keeps its own deque of tasks: it works on the newest one itself, while
+ * idle threads steal the oldest ones, which are the biggest subtrees.  While any
+ * thread is idle, busy threads hand over the unsearched moves of their shallowest
+ * open node as new tasks.  All threads share one lock free TranspositionTable, and
+ * the first thread to find a win stops the others.
+ *
+ * Moves are pruned and ordered exactly as in Solver, with the same exhaustive second
+ * pass before a LOSS, so the results agree apart from which winning line is found.
+ * The threads are started once and reused by every call to solve().
+ */
+class ParallelSolver
+{
+public:
+    explicit ParallelSolver(int threads = 0, int ttBits = 22);    ///< 0 threads = one per core
+    ~ParallelSolver();
+
+    ParallelSolver(const ParallelSolver&) = delete;
+    ParallelSolver& operator=(const ParallelSolver&) = delete;
+
+    SolveResult solve(const GameState& start, const SolverLimits& limits = SolverLimits());
+
+    const std::vector<Move>& solution() const { return mSolution; }
+    const SolverStats& stats() const { return mStats; }
+    int threadCount() const { return static_cast<int>(mWorkers.size()); }
+
+private:
+    struct Task {
+        GameState state;
+        std::vector<Move> path;         ///< Moves from the start position to state
+    };
+    struct Frame {
+        MoveList moves;
+        int next;
+        Move played;
+        UndoInfo undoInfo;
+    };
+    struct Worker {
+        std::mutex lock;                ///< Guards tasks
+        std::deque<Task> tasks;
+        std::vector<Frame> frames;
+        SolverStats stats;
+        std::thread thread;
+    };
+    static const int MAX_DEPTH{1024};
+
+    SolveResult runPass(const GameState& start, bool prune);
+    void threadMain(int index);
+    void work(int index);
+    bool takeTask(int index, Task& task);
+    void search(Worker& self, Task& task);
+    void foundWin(const Worker& self, const Task& task, int depth);
+    void donate(Worker& self, const Task& task, const GameState& state, int depth);
+    bool outOfBudget();
+
+    TranspositionTable mTable;
+    std::vector<std::unique_ptr<Worker>> mWorkers;
+
+    // Search in progress
+    SolverLimits mLimits;
+    std::chrono::steady_clock::time_point mStartTime;
+    std::atomic<bool> mStop;            ///< Set on a win or when the budget runs out
+    std::atomic<bool> mDepthLimited;
+    bool mPrune;                        ///< Set before the pool wakes, see Solver::orderMoves
+    std::atomic<int> mPending;          ///< Tasks queued or being searched
+    std::atomic<int> mHungry;           ///< Threads looking for work
+    std::atomic<uint64_t> mNodes;       ///< Shared node count, updated in batches
+
+    std::mutex mSolutionLock;
+    bool mWon;
+    std::vector<Move> mSolution;
+    SolverStats mStats;
+
+    // Thread pool
+    std::mutex mPoolLock;
+    std::condition_variable mWake;
+    std::condition_variable mDone;
+    uint64_t mGeneration;
+    int mRunning;
+    bool mQuit;
+};
+
+#endif // PARALLELSOLVER_H
@@ -0,0 +1,177 @@
+#include "perfhud.h"
+
+#include "cardanimator.h"
+#include "renderstats.h"
+
+#include <QFile>
+#include <QGraphicsView>
+#include <QPainter>
+#include <QTimer>
+#include <QUndoStack>
+
+#include <algorithm>
+
+static const int HUD_WIDTH{190};
+static const int HUD_HEIGHT{120};
+static const int HUD_MARGIN{6};
+static const int HISTOGRAM_HEIGHT{36};
+
+/// Upper bound of each histogram bucket in ms, the last one takes everything slower
+static const double BUCKET_LIMIT_MS[PerfHud::BUCKETS]{2.0, 4.0, 8.0, 16.7, 33.3, 1e9};
+static const char *BUCKET_LABELS[PerfHud::BUCKETS]{"2", "4", "8", "16", "33", "+"};
+
+PerfHud::PerfHud(QGraphicsView *view, const QUndoStack *undoStack)
+    : QObject{view}
+    , mView{view}
+    , mUndoStack{undoStack}
+    , mTimer{new QTimer(this)}
+    , mVisible{false}
+    , mFrameNs{}
+    , mFrameCount{0}
+    , mFramesSinceRefresh{0}
+    , mPaintsSinceRefresh{0}
+    , mWorstNs{0}
+    , mHistogram{}
+    , mFramesPerSecond{0.0}
+    , mPaintsPerFrame{0.0}
+    , mWorstMs{0.0}
+    , mAnimations{0}
+    , mUndoDepth{0}
+    , mResidentKB{-1}
+{
+    mTimer->setInterval(REFRESH_MS);
+    connect(mTimer, &QTimer::timeout, this, &PerfHud::refresh);
+}
+
+void PerfHud::setVisible(bool visible)
+{
+    if (visible == mVisible) {
+        return;
+    }
+    mVisible = visible;
+    RenderStats::setEnabled(visible);
+    if (visible) {
+        mFrameCount = 0;
+        mFramesSinceRefresh = 0;
+        mPaintsSinceRefresh = 0;
+        mWorstNs = 0;
+        refresh();
+        mTimer->start();
+    } else {
+        mTimer->stop();
+    }
+    mView->viewport()->update(rect());
+}
+
+/**
+ * @brief frameFinished - the view painted a frame in frameNs, with paints item paint() calls
+ */
+void PerfHud::frameFinished(qint64 frameNs, quint64 paints)
+{
+    mFrameNs[mFrameCount % HISTORY_FRAMES] = frameNs;
+    mFrameCount++;
+    mFramesSinceRefresh++;
+    mPaintsSinceRefresh += paints;
+    mWorstNs = std::max(mWorstNs, frameNs);
+}
+
+/**
+ * @brief rect - where the HUD is drawn, in viewport coordinates
+ */
+QRect PerfHud::rect() const
+{
+    const QRect viewport = mView->viewport()->rect();
+    return QRect(viewport.right() - HUD_WIDTH - HUD_MARGIN, viewport.top() + HUD_MARGIN, HUD_WIDTH, HUD_HEIGHT);
+}
+
+/**
+ * @brief refresh - take a new snapshot of the figures and repaint the HUD's corner
+ */
+void PerfHud::refresh()
+{
+    mHistogram.fill(0);
+    const int frames = mFrameCount < HISTORY_FRAMES ? mFrameCount : HISTORY_FRAMES;
+    for (int i = 0; i < frames; ++i) {
+        mHistogram[bucketOf(mFrameNs[i])]++;
+    }
+    mFramesPerSecond = mFramesSinceRefresh * 1000.0 / REFRESH_MS;
+    mPaintsPerFrame = mFramesSinceRefresh ? double(mPaintsSinceRefresh) / mFramesSinceRefresh : 0.0;
+    mWorstMs = mWorstNs / 1e6;
+    mAnimations = CardAnimator::instance()->trackCount();
+    mUndoDepth = mUndoStack ? mUndoStack->count() : 0;
+    mResidentKB = residentKB();
+
+    mFramesSinceRefresh = 0;
+    mPaintsSinceRefresh = 0;
+    mWorstNs = 0;
+    mView->viewport()->update(rect());
+}
+
+/**
+ * @brief paint - draw the last snapshot, painter in viewport coordinates
+ */
+void PerfHud::paint(QPainter *painter) const
+{
+    const QRect area = rect();
+    painter->save();
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(QColor(0, 0, 0, 170));
+    painter->drawRect(area);
+
+    painter->setPen(Qt::white);
+    const QRect text = area.adjusted(HUD_MARGIN, HUD_MARGIN, -HUD_MARGIN, -HUD_MARGIN);
+    painter->drawText(text, Qt::AlignLeft | Qt::AlignTop,
+                      QString("%1 fps  %2 items/frame\n"
+                              "worst %3 ms  anim %4  undo %5\n"
+                              "RSS %6")
+                          .arg(mFramesPerSecond, 0, 'f', 0)
+                          .arg(mPaintsPerFrame, 0, 'f', 1)
+                          .arg(mWorstMs, 0, 'f', 1)
+                          .arg(mAnimations)
+                          .arg(mUndoDepth)
+                          .arg(mResidentKB < 0 ? QString("?") : QString("%1 MB").arg(mResidentKB / 1024.0, 0, 'f', 1)));
+
+    // Frame time histogram along the bottom, slow buckets in red
+    const int maxCount = std::max(1, *std::max_element(mHistogram.begin(), mHistogram.end()));
+    const int barWidth = text.width() / BUCKETS;
+    const int baseline = text.bottom() - painter->fontMetrics().height();
+    for (int b = 0; b < BUCKETS; ++b) {
+        const int height = mHistogram[b] * HISTOGRAM_HEIGHT / maxCount;
+        const QRect bar(text.left() + b * barWidth + 1, baseline - height, barWidth - 2, height);
+        painter->fillRect(bar, BUCKET_LIMIT_MS[b] > 16.7 ? QColor(Qt::red) : QColor(Qt::green));
+        painter->drawText(QRect(bar.left(), baseline, barWidth - 2, painter->fontMetrics().height()),
+                          Qt::AlignCenter, BUCKET_LABELS[b]);
+    }
+    painter->restore();
+}
+
+/**
+ * @brief bucketOf - histogram bucket of a frame time
+ */
+int PerfHud::bucketOf(qint64 frameNs)
+{
+    const double ms = frameNs / 1e6;
+    int b = 0;
+    while (b < BUCKETS - 1 && ms > BUCKET_LIMIT_MS[b]) {
+        b++;
+    }
+    return b;
+}
+
+/**
+ * @brief residentKB - resident set size of this process, or -1 where it is not known
+ */
+long PerfHud::residentKB()
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const QByteArray& line : status.readAll().split('\n')) {
+            if (line.startsWith("VmRSS:")) {
+                return line.mid(6).trimmed().split(' ').first().toLong();
+            }
+        }
+    }
+#endif
+    return -1;
+}
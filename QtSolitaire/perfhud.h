@@ -0,0 +1,73 @@
+#ifndef PERFHUD_H
+#define PERFHUD_H
+
+#include <QObject>
+#include <QRect>
+
+#include <array>
+
+QT_FORWARD_DECLARE_CLASS(QGraphicsView)
+QT_FORWARD_DECLARE_CLASS(QPainter)
+QT_FORWARD_DECLARE_CLASS(QTimer)
+QT_FORWARD_DECLARE_CLASS(QUndoStack)
+
+/**
+ * @brief The PerfHud class is a performance overlay drawn in the corner of the Game view
+ *
+ * It shows a histogram of recent frame times, frames per second, item paint()
+ * calls per frame (see RenderStats), running animations, undo stack depth and the
+ * process's resident memory.  The view reports each frame with frameFinished(); the
+ * figures on screen are a snapshot taken REFRESH_MS apart, so the overlay only repaints
+ * its own corner a few times a second.
+ *
+ * While hidden nothing is recorded: RenderStats counting is switched off and the view
+ * skips its frame timing, one branch per paint.
+ */
+class PerfHud : public QObject
+{
+    Q_OBJECT
+public:
+    PerfHud(QGraphicsView *view, const QUndoStack *undoStack);
+
+    bool isVisible() const { return mVisible; }
+    void setVisible(bool visible);
+
+    void frameFinished(qint64 frameNs, quint64 paints);
+    void paint(QPainter *painter) const;
+    QRect rect() const;
+
+    static long residentKB();
+
+    static const int REFRESH_MS{250};
+    static const int HISTORY_FRAMES{120};       ///< Frames the histogram covers
+    static const int BUCKETS{6};                ///< Histogram buckets, see bucketOf()
+
+private slots:
+    void refresh();
+
+private:
+    static int bucketOf(qint64 frameNs);
+
+    QGraphicsView *mView;
+    const QUndoStack *mUndoStack;
+    QTimer *mTimer;
+    bool mVisible;
+
+    // Recorded since the HUD was shown
+    std::array<qint64, HISTORY_FRAMES> mFrameNs;    ///< Ring of recent frame times
+    int mFrameCount;                                ///< Frames recorded into mFrameNs
+    int mFramesSinceRefresh;
+    quint64 mPaintsSinceRefresh;
+    qint64 mWorstNs;
+
+    // Snapshot shown on screen, taken by refresh()
+    std::array<int, BUCKETS> mHistogram;
+    double mFramesPerSecond;
+    double mPaintsPerFrame;
+    double mWorstMs;
+    int mAnimations;
+    int mUndoDepth;
+    long mResidentKB;
+};
+
+#endif // PERFHUD_H
@@ -0,0 +1,74 @@
+#ifndef PRNG_H
+#define PRNG_H
+
+#include <cstdint>
+
+/**
+ * @brief splitMix64 - small, well mixed generator, used to expand a seed into more state
+ */
+constexpr uint64_t splitMix64(uint64_t& state)
+{
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Xoshiro256 - the xoshiro256** 1.0 generator of Blackman and Vigna
+ *
+ * 32 bytes of state and a handful of shifts and multiplies per number, against the
+ * 5 KB of std::mt19937.  The state is filled from the seed with splitMix64, as the
+ * authors recommend.  Results are fully specified, so they are the same with every
+ * compiler and standard library.
+ */
+class Xoshiro256
+{
+public:
+    explicit Xoshiro256(uint64_t seed)
+    {
+        for (uint64_t& word : mState) {
+            word = splitMix64(seed);
+        }
+    }
+
+    uint64_t next()
+    {
+        const uint64_t result = rotl(mState[1] * 5, 7) * 9;
+        const uint64_t t = mState[1] << 17;
+        mState[2] ^= mState[0];
+        mState[3] ^= mState[1];
+        mState[1] ^= mState[2];
+        mState[0] ^= mState[3];
+        mState[2] ^= t;
+        mState[3] = rotl(mState[3], 45);
+        return result;
+    }
+
+    /**
+     * @brief below - uniform number in [0, bound), bound > 0
+     *
+     * Lemire's multiply and shift on the top 32 bits of next(), rejecting the few low
+     * products that would make the result biased.
+     */
+    uint32_t below(uint32_t bound)
+    {
+        uint64_t product = (next() >> 32) * bound;
+        uint32_t low = static_cast<uint32_t>(product);
+        if (low < bound) {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (low < threshold) {
+                product = (next() >> 32) * bound;
+                low = static_cast<uint32_t>(product);
+            }
+        }
+        return static_cast<uint32_t>(product >> 32);
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+    uint64_t mState[4];
+};
+
+#endif // PRNG_H
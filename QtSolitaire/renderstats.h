@@ -0,0 +1,32 @@
+#ifndef RENDERSTATS_H
+#define RENDERSTATS_H
+
+#include <QtGlobal>
+
+/**
+ * @brief The RenderStats class counts the paint() calls of the card and stack items
+ *
+ * Counting is off unless something that reads the counts (a benchmark) turns it on,
+ * and then costs one predictable branch per paint() call.  GUI thread only.
+ */
+class RenderStats
+{
+public:
+    RenderStats() = delete;
+
+    static bool isEnabled() { return sEnabled; }
+    static void setEnabled(bool enabled) { sEnabled = enabled; }
+
+    static void countPaint() {
+        if (sEnabled) {
+            ++sPaints;
+        }
+    }
+    static quint64 paints() { return sPaints; }
+
+private:
+    static inline bool sEnabled{false};
+    static inline quint64 sPaints{0};        ///< paint() calls since the start
+};
+
+#endif // RENDERSTATS_H
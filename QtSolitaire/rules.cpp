@@ -0,0 +1,27 @@
+#include "rules.h"
+
+/******************************************************************************
+ * Bitboards Implementation
+ *****************************************************************************/
+Bitboards::Bitboards(const GameState& state)
+    : faceUp{state.faceUpMask()}
+    , exposed{0}
+{
+    for (int p = 0; p < NUM_PILES; ++p) {
+        Pile pl = static_cast<Pile>(p);
+        int size = state.pileSize(pl);
+        uint64_t members{0};
+        for (int i = 0; i < size; ++i) {
+            members |= cardBit(state.cardAt(pl, i));
+        }
+        pile[p] = members;
+        top[p] = size > 0 ? state.cardAt(pl, size-1) : NO_CARD;
+        accepts[p] = acceptMask(state, pl);
+
+        if (isTableauPile(p)) {
+            exposed |= members & faceUp;
+        } else if (p != PILE_HAND && top[p] != NO_CARD) {
+            exposed |= cardBit(top[p]);
+        }
+    }
+}
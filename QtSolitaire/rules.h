@@ -0,0 +1,129 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "cardtypes.h"
+#include "gamestate.h"
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+  * @brief Bitboard rules engine shared by the scene stacks and the headless tools
+  *
+  * Sets of cards are 64 bit masks indexed by CardId.  Whether a card may be added to a
+  * pile is decided by one lookup of the pile's "accept" mask and a shift, instead of
+  * comparing enums and QColors on Card items.
+  */
+
+constexpr uint64_t cardBit(CardId id) { return uint64_t{1} << id; }
+
+/**
+ * @brief lowestBit - index of the lowest set bit, mask must not be zero
+ */
+inline int lowestBit(uint64_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(mask);
+#endif
+}
+
+static const uint64_t ALL_CARDS_MASK{(uint64_t{1} << NUM_CARDS) - 1};
+static const uint64_t KINGS_MASK{cardBit(makeCardId(Suit::HEART, CardValue::KING)) |
+                                 cardBit(makeCardId(Suit::DIAMOND, CardValue::KING)) |
+                                 cardBit(makeCardId(Suit::SPADE, CardValue::KING)) |
+                                 cardBit(makeCardId(Suit::CLUB, CardValue::KING))};
+
+/**
+ * @brief StackTable is the 52x52 "may stack on" table for tableau columns
+ *
+ * Bit c of accepts[t] is set when card c may be placed on card t: one value lower
+ * and the opposite color.
+ */
+struct StackTable {
+    uint64_t accepts[NUM_CARDS];
+};
+
+constexpr StackTable makeStackTable()
+{
+    StackTable table{};
+    for (int t = 0; t < NUM_CARDS; ++t) {
+        for (int c = 0; c < NUM_CARDS; ++c) {
+            CardId top = static_cast<CardId>(t);
+            CardId card = static_cast<CardId>(c);
+            if (cardRank(card) + 1 == cardRank(top) && isRedCard(card) != isRedCard(top)) {
+                table.accepts[t] |= cardBit(card);
+            }
+        }
+    }
+    return table;
+}
+
+inline constexpr StackTable STACK_TABLE = makeStackTable();
+
+/**
+ * @brief acceptMask - the set of cards that may be added to a pile right now
+ *
+ * Empty tableau columns take any King, other columns take what the table allows on the
+ * top card (if it is face up), foundations take the next card of their suit, and
+ * nothing can be added to the hand or waste pile by the player.
+ */
+inline uint64_t acceptMask(const GameState& state, Pile pile)
+{
+    if (isTableauPile(pile)) {
+        CardId top = state.top(pile);
+        if (top == NO_CARD) {
+            return KINGS_MASK;
+        }
+        return state.isFaceUp(top) ? STACK_TABLE.accepts[top] : 0;
+    } else if (isFoundationPile(pile)) {
+        int size = state.pileSize(pile);
+        return size < CARDS_PER_SUIT ? cardBit(state.cardAt(pile, size)) : 0;
+    }
+    return 0;
+}
+
+inline bool canAddCard(const GameState& state, Pile pile, CardId card)
+{
+    return (acceptMask(state, pile) >> card) & 1;
+}
+
+/**
+ * @brief canTakeCard - true if card is the face up top card of pile
+ */
+inline bool canTakeCard(const GameState& state, Pile pile, CardId card)
+{
+    return state.top(pile) == card && state.isFaceUp(card);
+}
+
+/**
+ * @brief Bitboards is a precomputed view of a position for callers making many queries
+ *
+ *  - faceUp: every face up card
+ *  - exposed: cards that may be picked up: the waste and foundation tops, and every face
+ *    up tableau card (together with the cards on top of it)
+ *  - pile[p]: cards in pile p
+ *  - top[p]: top card of pile p, or NO_CARD
+ *  - accepts[p]: acceptMask() of pile p
+ */
+struct Bitboards {
+    uint64_t faceUp;
+    uint64_t exposed;
+    uint64_t pile[NUM_PILES];
+    uint64_t accepts[NUM_PILES];
+    CardId top[NUM_PILES];
+
+    explicit Bitboards(const GameState& state);
+
+    bool canAdd(Pile p, CardId card) const { return (accepts[p] >> card) & 1; }
+    bool canTake(Pile p, CardId card) const { return top[p] == card && ((exposed >> card) & 1); }
+    bool canTakeRun(Pile p, CardId card) const { return ((pile[p] & exposed) >> card) & 1; }
+};
+
+#endif // RULES_H
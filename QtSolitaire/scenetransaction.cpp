@@ -0,0 +1,93 @@
+#include "scenetransaction.h"
+
+#include "card.h"
+#include "cardstack.h"
+#include "trace.h"
+
+#include <QGraphicsScene>
+
+static const int INDEX_REBUILD_CARDS{8};    ///< Batches at least this big rebuild the scene index once
+
+SceneTransaction *SceneTransaction::sCurrent{nullptr};
+
+SceneTransaction::SceneTransaction(QGraphicsScene *scene)
+    : mScene{scene}
+    , mOuter{sCurrent}
+{
+    if (!mOuter) {
+        mPlacements.reserve(NUM_CARDS);
+    }
+    sCurrent = this;
+}
+
+SceneTransaction::~SceneTransaction()
+{
+    sCurrent = mOuter;
+    if (mOuter) {
+        // The outer transaction applies everything, in the order it was recorded
+        mOuter->mPlacements.insert(mOuter->mPlacements.end(), mPlacements.begin(), mPlacements.end());
+        for (CardStack *stack : mStacks) {
+            mOuter->touch(stack);
+        }
+        if (!mOuter->mScene) {
+            mOuter->mScene = mScene;
+        }
+    } else {
+        commit();
+    }
+}
+
+/**
+ * @brief place - record where card goes, a later place() of the same card wins
+ */
+void SceneTransaction::place(Card *card, CardStack *stack, const QPointF& pos, qreal z, bool faceUp)
+{
+    mPlacements.push_back(Placement{card, stack, pos, z, faceUp});
+}
+
+/**
+ * @brief touch - record that stack changed and needs one repaint
+ */
+void SceneTransaction::touch(CardStack *stack)
+{
+    if (!mStacks.contains(stack)) {
+        mStacks.append(stack);
+    }
+}
+
+void SceneTransaction::commit()
+{
+    TRACE_SPAN("scene", "SceneTransaction::commit");
+    const bool rebuildIndex = mScene && mPlacements.size() >= size_t(INDEX_REBUILD_CARDS) &&
+                              mScene->itemIndexMethod() != QGraphicsScene::NoIndex;
+    const QGraphicsScene::ItemIndexMethod indexMethod = mScene ? mScene->itemIndexMethod() : QGraphicsScene::NoIndex;
+    if (rebuildIndex) {
+        mScene->setItemIndexMethod(QGraphicsScene::NoIndex);
+    }
+
+    // Newest placement first, so each card is only touched once
+    bool placed[NUM_CARDS]{};
+    for (auto it = mPlacements.rbegin(); it != mPlacements.rend(); ++it) {
+        Card *card = it->card;
+        if (placed[card->cardId()]) {
+            continue;
+        }
+        placed[card->cardId()] = true;
+        if (card->parentItem() != it->stack) {
+            card->setParentItem(it->stack);
+        }
+        card->setPos(it->pos);
+        card->setZValue(it->z);
+        card->setFaceUp(it->faceUp);
+        card->setVisible(!it->stack->paintsCards());
+    }
+
+    if (rebuildIndex) {
+        mScene->setItemIndexMethod(indexMethod);
+    }
+    for (CardStack *stack : mStacks) {
+        stack->update();
+    }
+    mPlacements.clear();
+    mStacks.clear();
+}
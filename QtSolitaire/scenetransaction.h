@@ -0,0 +1,62 @@
+#ifndef SCENETRANSACTION_H
+#define SCENETRANSACTION_H
+
+#include "cardtypes.h"
+
+#include <QPointF>
+#include <QVector>
+
+#include <vector>
+
+class Card;
+class CardStack;
+QT_FORWARD_DECLARE_CLASS(QGraphicsScene)
+
+/**
+ * @brief The SceneTransaction class batches the card item changes of a multi-card move
+ *
+ * While a transaction is open, CardStack::syncFromModel() only records where each card
+ * belongs (stack, position, z value, face).  When the outermost transaction ends, all
+ * of it is applied in one pass: each card is reparented, moved and turned once however
+ * many stacks were synced, and every touched stack is updated once.  Cards that land
+ * on a stack which paints its own cards are hidden, all others are shown.  For a big batch,
+ * such as resetting the waste pile or a new deal, the scene's BSP index is switched off
+ * while the items move and rebuilt once afterwards, instead of being patched per item.
+ *
+ * Transactions nest: an inner one adds to the outer one and the outer one commits.
+ * Create them on the stack, GUI thread only.
+ */
+class SceneTransaction
+{
+public:
+    explicit SceneTransaction(QGraphicsScene *scene);
+    ~SceneTransaction();
+
+    SceneTransaction(const SceneTransaction&) = delete;
+    SceneTransaction& operator=(const SceneTransaction&) = delete;
+
+    static SceneTransaction* current() { return sCurrent; }
+
+    void place(Card *card, CardStack *stack, const QPointF& pos, qreal z, bool faceUp);
+    void touch(CardStack *stack);
+
+private:
+    struct Placement {
+        Card *card;
+        CardStack *stack;
+        QPointF pos;
+        qreal z;
+        bool faceUp;
+    };
+
+    void commit();
+
+    static SceneTransaction *sCurrent;
+
+    QGraphicsScene *mScene;
+    SceneTransaction *mOuter;
+    std::vector<Placement> mPlacements;
+    QVector<CardStack*> mStacks;
+};
+
+#endif // SCENETRANSACTION_H
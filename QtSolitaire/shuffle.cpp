@@ -0,0 +1,16 @@
+#include "shuffle.h"
+#include "prng.h"
+
+void shuffledDeck(uint64_t gameNumber, CardId order[NUM_CARDS])
+{
+    for (int i = 0; i < NUM_CARDS; ++i) {
+        order[i] = static_cast<CardId>(i);
+    }
+    Xoshiro256 rng(gameNumber);
+    for (int i = NUM_CARDS - 1; i > 0; --i) {
+        int j = static_cast<int>(rng.below(static_cast<uint32_t>(i + 1)));
+        CardId card = order[i];
+        order[i] = order[j];
+        order[j] = card;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef SHUFFLE_H
+#define SHUFFLE_H
+
+#include "cardtypes.h"
+
+#include <cstdint>
+
+/**
+ * @brief SHUFFLE_VERSION - bump if shuffledDeck() ever changes; every numbered game changes with it
+ */
+static const int SHUFFLE_VERSION{1};
+
+/**
+ * @brief shuffledDeck - the deck order of game number gameNumber
+ *
+ * The shuffle is fully specified, so game #N is the same deal on every machine and
+ * every build:
+ *  1. order[i] = i, the deck as Game::createCards builds it (card id order: Hearts,
+ *     Diamonds, Spades, Clubs, each Ace to King)
+ *  2. rng = Xoshiro256(gameNumber)
+ *  3. Fisher-Yates: for i = 51 down to 1, swap order[i] with order[rng.below(i + 1)]
+ *
+ * Pass the result to GameState::deal().
+ *
+ * @param gameNumber seed of the deal
+ * @param [out] order deck order, order[0] is the first card dealt
+ */
+void shuffledDeck(uint64_t gameNumber, CardId order[NUM_CARDS]);
+
+#endif // SHUFFLE_H
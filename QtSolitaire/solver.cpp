@@ -0,0 +1,284 @@
+#include "solver.h"
+#include "rules.h"
+#include "trace.h"
+
+#include <chrono>
+
+const char* solveResultName(SolveResult result)
+{
+    switch (result) {
+    case SolveResult::WIN: return "win";
+    case SolveResult::LOSS: return "loss";
+    case SolveResult::UNKNOWN: return "unknown";
+    }
+    return "unknown";
+}
+
+/******************************************************************************
+ * TranspositionTable Implementation
+ *****************************************************************************/
+TranspositionTable::TranspositionTable(int bits)
+    : mKeys(size_t{1} << bits)
+    , mBucketMask((uint64_t{1} << bits) / BUCKET_SIZE - 1)
+    , mGeneration{1}
+{
+}
+
+/**
+ * @brief clear - forget every position, only while no thread is inserting
+ */
+void TranspositionTable::clear()
+{
+    if (++mGeneration > GENERATIONS) {
+        for (std::atomic<uint64_t>& key : mKeys) {
+            key.store(0, std::memory_order_relaxed);
+        }
+        mGeneration = 1;
+    }
+}
+
+bool TranspositionTable::insert(uint64_t hash)
+{
+    std::atomic<uint64_t> *bucket = &mKeys[(hash & mBucketMask) * BUCKET_SIZE];
+    const uint64_t key = (hash & ~GENERATIONS) | mGeneration;
+    int free{-1};
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        uint64_t slot = bucket[i].load(std::memory_order_relaxed);
+        if (slot == key) {
+            return true;
+        }
+        if (free < 0 && (slot & GENERATIONS) != mGeneration) {
+            free = i;                       // unused, or left by an earlier search
+        }
+    }
+    // Bucket is full of this search's keys: the high bits of the hash pick the one to replace
+    bucket[free >= 0 ? free : int(hash >> 61)].store(key, std::memory_order_relaxed);
+    return false;
+}
+
+/******************************************************************************
+ * Solver Implementation
+ *****************************************************************************/
+Solver::Solver(int ttBits)
+    : mTable{ttBits}
+    , mFrames(MAX_DEPTH)
+{
+    mSolution.reserve(MAX_DEPTH);
+}
+
+/**
+ * @brief isSafeFoundationMove - true if card can go to its foundation and will never be
+ *        wanted back on the tableau
+ *
+ * Aces and twos are always safe.  Otherwise the card is only useful to hold the next
+ * lower cards of the opposite color, so once both of those are on their foundations
+ * the card may follow them.
+ */
+static bool isSafeFoundationMove(const GameState& state, CardId card)
+{
+    int rank = cardRank(card);
+    if (rank <= 2) {
+        return true;
+    }
+    bool red = isRedCard(card);
+    Suit first = red ? Suit::SPADE : Suit::HEART;
+    Suit second = red ? Suit::CLUB : Suit::DIAMOND;
+    return state.pileSize(foundationPile(first)) >= rank - 1 &&
+           state.pileSize(foundationPile(second)) >= rank - 1;
+}
+
+/**
+ * @brief orderMoves - generate, prune and order the moves worth searching
+ *
+ * @param prune false keeps every move that can matter, for a search that proves losses
+ * @return number of moves left in list, best first
+ */
+int Solver::orderMoves(const GameState& state, MoveList& list, bool prune)
+{
+    generateMoves(state, list);
+
+    int scores[MAX_MOVES];
+    int kept{0};
+    for (int i = 0; i < list.size; ++i) {
+        const Move m = list.moves[i];
+        const Pile from = m.from();
+        const Pile to = m.to();
+        int score{0};
+
+        if (isFoundationPile(to)) {
+            CardId card = movedCard(state, m);
+            if (isSafeFoundationMove(state, card)) {
+                if (prune) {
+                    list.moves[0] = m;
+                    list.size = 1;
+                    return 1;
+                }
+                score = 1100;
+            } else {
+                score = m.flips() ? 1000 : 900;
+            }
+        } else if (from == PILE_HAND) {
+            score = 300;
+        } else if (to == PILE_HAND) {
+            score = 200;
+        } else if (from == PILE_WASTE) {
+            score = 500;
+        } else if (isFoundationPile(from)) {
+            score = 50;
+        } else {
+            // Tableau to tableau
+            int size = state.pileSize(from);
+            int down = state.faceDownCount(from);
+            int start = size - m.count();
+            if (m.flips()) {
+                score = 800 + down;
+            } else if (start == 0) {
+                // Emptying a column is pointless if a King just moves to another empty column
+                if (cardRank(state.cardAt(from, 0)) == CARDS_PER_SUIT) {
+                    continue;
+                }
+                score = 100;
+            } else if (start > down) {
+                // Splitting a run mostly helps when the card underneath can then go up
+                CardId exposed = state.cardAt(from, start - 1);
+                if (state.pileSize(foundationPile(cardSuit(exposed))) == cardRank(exposed) - 1) {
+                    score = 700;
+                } else if (prune) {
+                    continue;
+                } else {
+                    score = 10;
+                }
+            } else {
+                continue;
+            }
+        }
+        list.moves[kept] = m;
+        scores[kept] = score;
+        kept++;
+    }
+    list.size = kept;
+
+    // Insertion sort, best first; lists are short
+    for (int i = 1; i < kept; ++i) {
+        Move m = list.moves[i];
+        int score = scores[i];
+        int j = i - 1;
+        while (j >= 0 && scores[j] < score) {
+            list.moves[j + 1] = list.moves[j];
+            scores[j + 1] = scores[j];
+            j--;
+        }
+        list.moves[j + 1] = m;
+        scores[j + 1] = score;
+    }
+    return kept;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief solve - search for a win from start
+ *
+ * A pruned pass runs first; if it finds no win, an exhaustive pass decides between WIN
+ * and LOSS.  Both passes share the budget.
+ *
+ * @param start position to solve, it is not modified
+ * @param limits node and time budget
+ * @return WIN (solution() holds the moves), LOSS, or UNKNOWN if the budget ran out
+ */
+SolveResult Solver::solve(const GameState& start, const SolverLimits& limits)
+{
+    TRACE_SPAN("engine", "Solver::solve");
+    const Clock::time_point startTime = Clock::now();
+
+    mStats = SolverStats();
+    mSolution.clear();
+
+    SolveResult result{SolveResult::WIN};
+    if (!start.isWon()) {
+        result = search(start, limits, true, startTime);
+        if (result == SolveResult::LOSS) {
+            result = search(start, limits, false, startTime);
+        }
+    }
+    mStats.seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+    return result;
+}
+
+/**
+ * @brief search - one depth first pass, adding to mStats
+ *
+ * The time limit counts from startTime, the start of solve(); the node limit covers
+ * every pass.
+ */
+SolveResult Solver::search(const GameState& start, const SolverLimits& limits, bool prune,
+                           std::chrono::steady_clock::time_point startTime)
+{
+    const uint64_t CHECK_INTERVAL{4096};
+
+    GameState state = start;
+    SolveResult result = SolveResult::LOSS;
+    bool depthLimited{false};
+
+    mStats.passes++;
+    mTable.clear();
+    mTable.insert(state.hash());
+    int depth{0};
+    orderMoves(state, mFrames[0].moves, prune);
+    mFrames[0].next = 0;
+
+    while (depth >= 0) {
+        Frame& frame = mFrames[depth];
+        if (frame.next == frame.moves.size) {
+            // All children searched: back up to the parent
+            depth--;
+            if (depth >= 0) {
+                unmakeMove(state, mFrames[depth].played, mFrames[depth].undoInfo);
+            }
+            continue;
+        }
+
+        const Move m = frame.moves[frame.next++];
+        frame.played = m;
+        frame.undoInfo = makeMove(state, m);
+        mStats.nodes++;
+
+        if (state.isWon()) {
+            for (int d = 0; d <= depth; ++d) {
+                mSolution.push_back(mFrames[d].played);
+            }
+            result = SolveResult::WIN;
+            break;
+        }
+
+        if ((mStats.nodes % CHECK_INTERVAL) == 0 &&
+            ((limits.maxNodes && mStats.nodes >= limits.maxNodes) ||
+             (limits.maxSeconds > 0.0 &&
+              std::chrono::duration<double>(Clock::now() - startTime).count() >= limits.maxSeconds))) {
+            result = SolveResult::UNKNOWN;
+            break;
+        }
+
+        mStats.ttProbes++;
+        if (mTable.insert(state.hash())) {
+            mStats.ttHits++;
+            unmakeMove(state, m, frame.undoInfo);
+            continue;
+        }
+
+        if (depth + 1 >= MAX_DEPTH) {
+            depthLimited = true;
+            unmakeMove(state, m, frame.undoInfo);
+            continue;
+        }
+
+        depth++;
+        orderMoves(state, mFrames[depth].moves, prune);
+        mFrames[depth].next = 0;
+    }
+
+    if (result == SolveResult::LOSS && depthLimited) {
+        result = SolveResult::UNKNOWN;
+    }
+    return result;
+}
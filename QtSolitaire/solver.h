@@ -0,0 +1,127 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include "gamestate.h"
+#include "moves.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief SolveResult - outcome of a search
+ */
+enum class SolveResult {
+    WIN,            ///< A winning line was found, see Solver::solution()
+    LOSS,           ///< Proven: an exhaustive search of the game tree found no win
+    UNKNOWN         ///< Ran out of nodes or time first
+};
+
+const char* solveResultName(SolveResult result);
+
+/**
+ * @brief SolverLimits - search budget, zero means unlimited
+ */
+struct SolverLimits {
+    uint64_t maxNodes{0};
+    double maxSeconds{0.0};
+};
+
+/**
+ * @brief SolverStats - counters for the last search
+ */
+struct SolverStats {
+    uint64_t nodes{0};              ///< Positions reached by making a move
+    uint64_t ttProbes{0};
+    uint64_t ttHits{0};             ///< Positions skipped because they were already searched
+    double seconds{0.0};
+    int passes{0};                  ///< 2 when the pruned pass found no win and the exhaustive one ran
+    uint64_t tasks{0};              ///< Subtrees searched, parallel search only
+    uint64_t steals{0};             ///< Subtrees taken from another thread, parallel search only
+
+    double ttHitRate() const { return ttProbes ? double(ttHits)/double(ttProbes) : 0.0; }
+};
+
+/**
+ * @brief TranspositionTable is a fixed size set of position hashes
+ *
+ * The table has 2^bits slots grouped in cache line sized buckets of eight.  A full
+ * bucket overwrites one of its entries, which only costs re-searching that position.
+ * Each key carries the generation of the search that stored it in its low bits, which
+ * the bucket index already implies.  clear() only starts a new generation, and slots
+ * of older generations count as empty, so clearing a large table costs nothing.  The
+ * table is really zeroed once every GENERATIONS clears, when the tag wraps around.
+ *
+ * insert() is lock free and may be called from several threads at once.  Two threads
+ * racing for the same empty slot can lose one of the keys, which again only costs a
+ * re-search, so plain relaxed loads and stores are enough.
+ */
+class TranspositionTable
+{
+public:
+    explicit TranspositionTable(int bits);
+
+    void clear();
+    bool insert(uint64_t hash);     ///< @return true if hash was already present
+
+    static const int GENERATION_BITS{8};
+    static const uint64_t GENERATIONS{(uint64_t{1} << GENERATION_BITS) - 1};   ///< Tag 0 marks an unused slot
+
+private:
+    static const int BUCKET_SIZE{8};
+
+    std::vector<std::atomic<uint64_t>> mKeys;
+    uint64_t mBucketMask;
+    uint64_t mGeneration;               ///< 1..GENERATIONS
+};
+
+/**
+ * @brief Solver is a depth first search for a winning line of play
+ *
+ * The search runs on its own copy of the position with makeMove/unmakeMove and an
+ * explicit stack of frames (no recursion), so it is safe on small thread stacks.
+ * Visited positions go in a TranspositionTable keyed by GameState::hash(), which also
+ * stops the search from cycling through the hand forever.
+ *
+ * The move generator's output is ordered before searching, foundation and card-revealing
+ * moves first and foundation to tableau last.  The first pass also prunes it:
+ *  - a foundation move that is very unlikely to be needed back ("safe") is played alone
+ *  - tableau runs move only if that turns over a card, empties a column (unless
+ *    the run starts with a King) or lets the exposed card go to its foundation
+ * That finds most wins quickly, but it can skip a move a win needs, such as splitting a
+ * run so another card can land on the exposed one.  So when the pruned pass finds no
+ * win, a second pass searches every move (bar a King run moving between empty columns,
+ * which changes nothing) within what is left of the budget, and only that proves a LOSS.
+ */
+class Solver
+{
+public:
+    explicit Solver(int ttBits = 22);
+
+    SolveResult solve(const GameState& start, const SolverLimits& limits = SolverLimits());
+
+    const std::vector<Move>& solution() const { return mSolution; }
+    const SolverStats& stats() const { return mStats; }
+
+    static int orderMoves(const GameState& state, MoveList& list, bool prune = true);
+
+private:
+    struct Frame {
+        MoveList moves;
+        int next;
+        Move played;
+        UndoInfo undoInfo;
+    };
+    static const int MAX_DEPTH{1024};
+
+    SolveResult search(const GameState& start, const SolverLimits& limits, bool prune,
+                       std::chrono::steady_clock::time_point startTime);
+
+    TranspositionTable mTable;
+    std::vector<Frame> mFrames;
+    std::vector<Move> mSolution;
+    SolverStats mStats;
+};
+
+#endif // SOLVER_H
@@ -0,0 +1,33 @@
+#include "svgcache.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QSvgRenderer>
+
+QHash<QString, QSvgRenderer*>& SvgCache::cache()
+{
+    static QHash<QString, QSvgRenderer*> renderers;
+    return renderers;
+}
+
+/**
+ * @brief renderer - the shared renderer for the SVG file at path, parsing it on first use
+ *
+ * @param path file or resource path, e.g. ":/images/Card-Back.svg"
+ * @return renderer, check isValid() if the file may be missing
+ */
+QSvgRenderer* SvgCache::renderer(const QString& path)
+{
+    QHash<QString, QSvgRenderer*>& renderers = cache();
+    auto it = renderers.constFind(path);
+    if (it != renderers.constEnd()) {
+        return it.value();
+    }
+
+    QSvgRenderer *svgRenderer = new QSvgRenderer(path, QCoreApplication::instance());
+    if (!svgRenderer->isValid()) {
+        qWarning() << "Could not load SVG" << path;
+    }
+    renderers.insert(path, svgRenderer);
+    return svgRenderer;
+}
@@ -0,0 +1,29 @@
+#ifndef SVGCACHE_H
+#define SVGCACHE_H
+
+#include <QHash>
+#include <QString>
+
+QT_FORWARD_DECLARE_CLASS(QSvgRenderer)
+
+/**
+ * @brief The SvgCache class holds one QSvgRenderer per SVG file for the whole process
+ *
+ * Each file is parsed the first time it is asked for, and every QGraphicsSvgItem that
+ * shows it shares that renderer through setSharedRenderer(), so the card back is parsed
+ * once rather than 52 times.  Renderers are children of the application object and are
+ * deleted with it.  Only call from the GUI thread.
+ */
+class SvgCache
+{
+public:
+    SvgCache() = delete;
+
+    static QSvgRenderer* renderer(const QString& path);
+    static int size() { return cache().size(); }
+
+private:
+    static QHash<QString, QSvgRenderer*>& cache();
+};
+
+#endif // SVGCACHE_H
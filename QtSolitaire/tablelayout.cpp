@@ -0,0 +1,143 @@
+#include "tablelayout.h"
+
+#include <QLineF>
+#include <QtMath>
+
+static const int FOUNDATION_COLUMN{3};      ///< Column of the first foundation in the top row
+
+/**
+ * @brief column - grid column of a pile, 0 is the left edge of the table
+ */
+int TableLayout::column(Pile pile)
+{
+    if (pile == PILE_HAND) {
+        return 0;
+    } else if (pile == PILE_WASTE) {
+        return 1;
+    } else if (isFoundationPile(pile)) {
+        return FOUNDATION_COLUMN + (pile - PILE_FOUNDATION);
+    }
+    return pile - PILE_TABLEAU;
+}
+
+/**
+ * @brief pileAt - pile in a grid column of the top row or the tableau, or NUM_PILES
+ */
+Pile TableLayout::pileAt(int column, bool tableau)
+{
+    if (column < 0 || column >= NUM_PLAY_STACKS) {
+        return NUM_PILES;
+    }
+    if (tableau) {
+        return tableauPile(column);
+    }
+    if (column >= FOUNDATION_COLUMN) {
+        return static_cast<Pile>(PILE_FOUNDATION + column - FOUNDATION_COLUMN);
+    }
+    static const Pile TOP_ROW[FOUNDATION_COLUMN]{PILE_HAND, PILE_WASTE, NUM_PILES};
+    return TOP_ROW[column];
+}
+
+QPointF TableLayout::pilePos(Pile pile)
+{
+    return QPointF(CARD_SPACING + CARD_WIDTH/2.0 + column(pile) * COLUMN_PITCH,
+                   isTableauPile(pile) ? TABLEAU_ROW_Y : TOP_ROW_Y);
+}
+
+/**
+ * @brief cardPos - centre of the card at index (0 = bottom) of a pile, as the stacks lay them out
+ */
+QPointF TableLayout::cardPos(Pile pile, int index)
+{
+    QPointF pos = pilePos(pile);
+    if (isTableauPile(pile)) {
+        pos.ry() += index * CARD_OVERLAP;
+    }
+    return pos;
+}
+
+/**
+ * @brief dropRect - the area of the table a card dropped on pile lands in: its top card
+ *        or, for an empty pile, its empty slot
+ */
+QRectF TableLayout::dropRect(Pile pile, const GameState& state)
+{
+    QPointF centre = cardPos(pile, qMax(0, state.pileSize(pile) - 1));
+    return QRectF(centre.x() - CARD_WIDTH/2.0, centre.y() - CARD_HEIGHT/2.0, CARD_WIDTH, CARD_HEIGHT);
+}
+
+/**
+ * @brief pileAt - the pile whose cards (or empty slot) cover scenePos, or NUM_PILES
+ *
+ * Constant time: the column comes from the x coordinate, the row from y, and a tableau
+ * column's length from the number of cards in it.
+ */
+Pile TableLayout::pileAt(const QPointF& scenePos, const GameState& state)
+{
+    const double x = scenePos.x() - CARD_SPACING;
+    const int c = qFloor(x / COLUMN_PITCH);
+    if (x < 0 || x - c * COLUMN_PITCH > CARD_WIDTH) {
+        return NUM_PILES;
+    }
+
+    const double y = scenePos.y();
+    const double topRow = TOP_ROW_Y - CARD_HEIGHT/2.0;
+    if (y >= topRow && y <= topRow + CARD_HEIGHT) {
+        return pileAt(c, false);
+    }
+    const double tableauTop = TABLEAU_ROW_Y - CARD_HEIGHT/2.0;
+    Pile pile = pileAt(c, true);
+    if (pile == NUM_PILES || y < tableauTop) {
+        return NUM_PILES;
+    }
+    const int cards = state.pileSize(pile);
+    return y <= tableauTop + qMax(0, cards - 1) * CARD_OVERLAP + CARD_HEIGHT ? pile : NUM_PILES;
+}
+
+/**
+ * @brief cardIndexAt - index of the card of pile that shows at scenePos, or -1
+ *
+ * Only a CARD_OVERLAP strip of each card in a tableau column shows, except the top
+ * card, so this is the same constant time arithmetic as pileAt().
+ */
+int TableLayout::cardIndexAt(const QPointF& scenePos, Pile pile, const GameState& state)
+{
+    const int cards = state.pileSize(pile);
+    const QPointF offset = scenePos - pilePos(pile) + QPointF(CARD_WIDTH/2.0, CARD_HEIGHT/2.0);
+    if (cards == 0 || offset.x() < 0 || offset.x() > CARD_WIDTH || offset.y() < 0) {
+        return -1;
+    }
+    if (!isTableauPile(pile)) {
+        return offset.y() <= CARD_HEIGHT ? cards - 1 : -1;
+    }
+    if (offset.y() > (cards - 1) * CARD_OVERLAP + CARD_HEIGHT) {
+        return -1;
+    }
+    return qMin(cards - 1, qFloor(offset.y() / CARD_OVERLAP));
+}
+
+/**
+ * @brief nearestPile - of the piles set in the bit mask, the one whose dropRect() is
+ *        closest to scenePos, if it is within maxDistance
+ *
+ * @return the pile, or NUM_PILES
+ */
+Pile TableLayout::nearestPile(const QPointF& scenePos, unsigned piles, const GameState& state, double maxDistance)
+{
+    Pile best{NUM_PILES};
+    double bestDistance{maxDistance};
+    for (int p = 0; p < NUM_PILES; ++p) {
+        if (!((piles >> p) & 1)) {
+            continue;
+        }
+        const QRectF rect = dropRect(static_cast<Pile>(p), state);
+        const QPointF closest(qBound(rect.left(), scenePos.x(), rect.right()),
+                              qBound(rect.top(), scenePos.y(), rect.bottom()));
+        const double distance = QLineF(scenePos, closest).length();
+        if (distance <= bestDistance) {
+            best = static_cast<Pile>(p);
+            bestDistance = distance;
+        }
+    }
+    return best;
+}
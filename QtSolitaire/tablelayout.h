@@ -0,0 +1,39 @@
+#ifndef TABLELAYOUT_H
+#define TABLELAYOUT_H
+
+#include "constants.h"
+#include "gamestate.h"
+
+#include <QPointF>
+#include <QRectF>
+
+/**
+ * @brief The TableLayout class is where every pile lies on the table, worked out from constants.h
+ *
+ * The table is a grid of NUM_PLAY_STACKS columns, CARD_WIDTH wide with CARD_SPACING
+ * between them, and two rows: hand, waste, a gap and the four foundations on top, the
+ * tableau columns below, whose cards overlap by CARD_OVERLAP.  A scene point is turned
+ * into a pile with a little arithmetic on that grid instead of asking the scene which
+ * items are under it.  All positions are card centres in scene coordinates.
+ */
+class TableLayout
+{
+public:
+    TableLayout() = delete;
+
+    static constexpr double COLUMN_PITCH{CARD_WIDTH + CARD_SPACING};
+    static constexpr double TOP_ROW_Y{TOP_MARGIN + CARD_HEIGHT/2.0};
+    static constexpr double TABLEAU_ROW_Y{TOP_MARGIN + 3*CARD_HEIGHT/2.0 + CARD_SPACING};
+
+    static QPointF pilePos(Pile pile);
+    static QPointF cardPos(Pile pile, int index);
+    static QRectF dropRect(Pile pile, const GameState& state);
+
+    static int column(Pile pile);
+    static Pile pileAt(int column, bool tableau);
+    static Pile pileAt(const QPointF& scenePos, const GameState& state);
+    static int cardIndexAt(const QPointF& scenePos, Pile pile, const GameState& state);
+    static Pile nearestPile(const QPointF& scenePos, unsigned piles, const GameState& state, double maxDistance);
+};
+
+#endif // TABLELAYOUT_H
@@ -0,0 +1,112 @@
+/**
+  * @brief solitaire-hash-check: play random legal move sequences and check the position hash
+  *
+  * Each seeded deal is played with random moves from generateMoves(), taking moves back
+  * with unmakeMove() now and then the way undo does, and finally unwinding to the deal.
+  * After every step the incremental hash must match GameState::computeHash(), and an
+  * unmade move must give back exactly the position it was made from.  The engine is
+  * built into this test with SOLITAIRE_CHECK_HASH, so makeMove/unmakeMove check too.
+  *
+  * Usage: solitaire-hash-check [deals] [steps]   (defaults 200 and 500)
+  * Exits with 1 and prints the failing move on a mismatch.  Runs without Qt.
+  */
+#include "gamestate.h"
+#include "moves.h"
+#include "prng.h"
+#include "shuffle.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+struct Played {
+    Move move;
+    UndoInfo undoInfo;
+    GameState before;
+};
+
+static bool check(const GameState& state, uint64_t seed, int step, Move move, const char *what)
+{
+    if (state.hash() == state.computeHash()) {
+        return true;
+    }
+    std::fprintf(stderr, "deal %" PRIu64 " step %d: hash mismatch after %s of %d -> %d, %d cards%s\n",
+                 seed, step, what, move.from(), move.to(), move.count(), move.flips() ? ", flip" : "");
+    return false;
+}
+
+static bool playDeal(uint64_t seed, int steps)
+{
+    CardId order[NUM_CARDS];
+    shuffledDeck(seed, order);
+    GameState state;
+    state.deal(order);
+    const GameState dealt = state;
+    if (!check(state, seed, 0, Move(), "the deal")) {
+        return false;
+    }
+
+    Xoshiro256 rng(seed);
+    std::vector<Played> history;
+    MoveList moves;
+    for (int step = 1; step <= steps; ++step) {
+        // Undo about one move in four
+        if (!history.empty() && rng.below(4) == 0) {
+            const Played& last = history.back();
+            unmakeMove(state, last.move, last.undoInfo);
+            if (!check(state, seed, step, last.move, "unmakeMove")) {
+                return false;
+            }
+            if (state != last.before) {
+                std::fprintf(stderr, "deal %" PRIu64 " step %d: unmakeMove of %d -> %d did not restore the position\n",
+                             seed, step, last.move.from(), last.move.to());
+                return false;
+            }
+            history.pop_back();
+            continue;
+        }
+
+        if (generateMoves(state, moves) == 0) {
+            break;
+        }
+        const Move move = moves[static_cast<int>(rng.below(moves.size))];
+        history.push_back(Played{move, UndoInfo{}, state});
+        history.back().undoInfo = makeMove(state, move);
+        if (!check(state, seed, step, move, "makeMove")) {
+            return false;
+        }
+    }
+
+    while (!history.empty()) {
+        const Played& last = history.back();
+        unmakeMove(state, last.move, last.undoInfo);
+        if (!check(state, seed, steps, last.move, "unwinding unmakeMove")) {
+            return false;
+        }
+        history.pop_back();
+    }
+    if (state != dealt) {
+        std::fprintf(stderr, "deal %" PRIu64 ": unwinding every move did not restore the deal\n", seed);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    const int deals = argc > 1 ? std::atoi(argv[1]) : 200;
+    const int steps = argc > 2 ? std::atoi(argv[2]) : 500;
+    if (deals < 1 || steps < 1) {
+        std::fprintf(stderr, "Usage: solitaire-hash-check [deals] [steps], both at least 1\n");
+        return 2;
+    }
+
+    for (int d = 0; d < deals; ++d) {
+        if (!playDeal(static_cast<uint64_t>(d), steps)) {
+            return 1;
+        }
+    }
+    std::printf("%d deals of up to %d steps: hashes consistent\n", deals, steps);
+    return 0;
+}
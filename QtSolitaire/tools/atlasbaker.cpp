@@ -0,0 +1,66 @@
+/**
+  * @brief solitaire-atlas-baker: pre-render the card atlas at build time
+  *
+  * Usage: solitaire-atlas-baker <output directory> <scale>...
+  * Writes cards@<scale>x.png for every scale, and cardatlas.txt, the table CardAtlas
+  * reads back from the ":/atlas/" resources.  Runs on the offscreen platform unless
+  * QT_QPA_PLATFORM is set.
+  */
+#include "cardatlas.h"
+
+#include <QDir>
+#include <QFile>
+#include <QGuiApplication>
+#include <QImage>
+#include <QTextStream>
+
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QGuiApplication app(argc, argv);
+
+    if (argc < 3) {
+        std::fprintf(stderr, "Usage: %s <output directory> <scale>...\n", argv[0]);
+        return 2;
+    }
+    QDir dir(QString::fromLocal8Bit(argv[1]));
+    if (!dir.mkpath(".")) {
+        std::fprintf(stderr, "Cannot create %s\n", argv[1]);
+        return 1;
+    }
+
+    QString table;
+    QTextStream out(&table);
+    out << "# scale cellWidth cellHeight columns cells file\n";
+    for (int i = 2; i < argc; ++i) {
+        bool ok{false};
+        const QString scaleText = QString::fromLatin1(argv[i]);
+        const qreal scale = scaleText.toDouble(&ok);
+        if (!ok || scale <= 0.0) {
+            std::fprintf(stderr, "Bad scale %s\n", argv[i]);
+            return 2;
+        }
+
+        const QString file = QStringLiteral("cards@%1x.png").arg(scaleText);
+        const QImage image = CardAtlas::renderImage(scale);
+        if (!image.save(dir.filePath(file), "PNG")) {
+            std::fprintf(stderr, "Cannot write %s\n", qPrintable(dir.filePath(file)));
+            return 1;
+        }
+        const QSize cell = CardAtlas::cellSize(scale);
+        out << scaleText << ' ' << cell.width() << ' ' << cell.height() << ' ' << CardAtlas::ATLAS_COLUMNS
+            << ' ' << CardAtlas::ATLAS_CELLS << ' ' << file << '\n';
+    }
+    out.flush();
+
+    QFile tableFile(dir.filePath(QStringLiteral("cardatlas.txt")));
+    if (!tableFile.open(QIODevice::WriteOnly | QIODevice::Text) || tableFile.write(table.toLatin1()) < 0) {
+        std::fprintf(stderr, "Cannot write %s\n", qPrintable(tableFile.fileName()));
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,255 @@
+/**
+  * @brief solitaire-census: solve a range of seeded deals and record the outcomes
+  *
+  * Seed N is dealt exactly as the game deals game #N (shuffledDeck() + GameState::deal())
+  * and solved with its own node/time budget.  Runs without Qt.
+  *
+  * Usage: solitaire-census [options]
+  *   --first N       first seed (default 0)
+  *   --count N       number of seeds (default 1000)
+  *   --threads N     worker threads, 0 = one per core (default 0)
+  *   --nodes N       node budget per deal, 0 = unlimited (default 1000000)
+  *   --ms N          time budget per deal in milliseconds, 0 = unlimited (default 0)
+  *   --tt-bits N     transposition table size per thread, 2^N entries (default 20)
+  *   --format F      csv or binary (default csv)
+  *   --output FILE   output file (default standard output)
+  *
+  * CSV output has the header "seed,outcome,nodes,ms".  Binary output starts with the
+  * 8 bytes "KCENSUS1" followed by one 24 byte little endian record per seed:
+  *   uint64 seed, uint64 nodes, uint32 microseconds, uint8 outcome (0 win, 1 loss,
+  *   2 unknown), 3 bytes zero padding.
+  * Records are written in seed order.  A summary goes to standard error, and the exit
+  * status is 1 if the output could not be written in full.  Losses are proven (see
+  * SolveResult), so the win rate lies between the wins and the wins plus the unknowns.
+  */
+#include "gamestate.h"
+#include "shuffle.h"
+#include "solver.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct CensusOptions {
+    uint64_t first{0};
+    uint64_t count{1000};
+    int threads{0};
+    SolverLimits limits;
+    int ttBits{20};
+    bool binary{false};
+    const char *output{nullptr};
+};
+
+struct CensusRecord {
+    uint64_t seed;
+    uint64_t nodes;
+    uint32_t micros;
+    SolveResult result;
+};
+
+/**
+ * @brief CensusWriter streams records in seed order, whatever order the chunks finish in
+ */
+class CensusWriter
+{
+public:
+    CensusWriter(FILE *file, bool binary)
+        : mFile{file}
+        , mBinary{binary}
+        , mFailed{false}
+        , mNextChunk{0}
+    {
+        if (mBinary) {
+            mFailed = std::fwrite("KCENSUS1", 1, 8, mFile) != 8;
+        } else {
+            mFailed = std::fputs("seed,outcome,nodes,ms\n", mFile) < 0;
+        }
+    }
+
+    /** @brief failed - true once a write has failed (a full disk, say), later records are dropped */
+    bool failed() const { return mFailed; }
+
+    void add(uint64_t chunk, std::vector<CensusRecord>&& records)
+    {
+        std::lock_guard<std::mutex> lock(mLock);
+        if (mFailed) {
+            return;
+        }
+        mPending[chunk] = std::move(records);
+        while (!mPending.empty() && mPending.begin()->first == mNextChunk) {
+            for (const CensusRecord& record : mPending.begin()->second) {
+                if (!write(record)) {
+                    mFailed = true;
+                    return;
+                }
+            }
+            mPending.erase(mPending.begin());
+            mNextChunk++;
+        }
+    }
+
+private:
+    bool write(const CensusRecord& record)
+    {
+        if (mBinary) {
+            unsigned char bytes[24]{};
+            for (int i = 0; i < 8; ++i) {
+                bytes[i] = static_cast<unsigned char>(record.seed >> (8 * i));
+                bytes[8 + i] = static_cast<unsigned char>(record.nodes >> (8 * i));
+            }
+            for (int i = 0; i < 4; ++i) {
+                bytes[16 + i] = static_cast<unsigned char>(record.micros >> (8 * i));
+            }
+            bytes[20] = static_cast<unsigned char>(record.result);
+            return std::fwrite(bytes, 1, sizeof(bytes), mFile) == sizeof(bytes);
+        }
+        return std::fprintf(mFile, "%llu,%s,%llu,%.3f\n", static_cast<unsigned long long>(record.seed),
+                            solveResultName(record.result), static_cast<unsigned long long>(record.nodes),
+                            record.micros / 1000.0) >= 0;
+    }
+
+    FILE *mFile;
+    bool mBinary;
+    std::atomic<bool> mFailed;
+    std::mutex mLock;
+    uint64_t mNextChunk;
+    std::map<uint64_t, std::vector<CensusRecord>> mPending;
+};
+
+static void usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [--first N] [--count N] [--threads N] [--nodes N] [--ms N]\n"
+                 "          [--tt-bits N] [--format csv|binary] [--output FILE]\n", program);
+}
+
+static bool parseOptions(int argc, char *argv[], CensusOptions& options)
+{
+    options.limits.maxNodes = 1000000;
+    for (int i = 1; i < argc; ++i) {
+        const char *name = argv[i];
+        if (i + 1 >= argc) {
+            return false;
+        }
+        const char *value = argv[++i];
+        if (std::strcmp(name, "--first") == 0) {
+            options.first = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(name, "--count") == 0) {
+            options.count = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(name, "--threads") == 0) {
+            options.threads = std::atoi(value);
+        } else if (std::strcmp(name, "--nodes") == 0) {
+            options.limits.maxNodes = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(name, "--ms") == 0) {
+            options.limits.maxSeconds = std::atof(value) / 1000.0;
+        } else if (std::strcmp(name, "--tt-bits") == 0) {
+            options.ttBits = std::atoi(value);
+        } else if (std::strcmp(name, "--format") == 0) {
+            if (std::strcmp(value, "binary") == 0) {
+                options.binary = true;
+            } else if (std::strcmp(value, "csv") != 0) {
+                return false;
+            }
+        } else if (std::strcmp(name, "--output") == 0) {
+            options.output = value;
+        } else {
+            return false;
+        }
+    }
+    if (options.first + options.count < options.first || options.ttBits < 3 || options.ttBits > 32) {
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    CensusOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    FILE *file = stdout;
+    if (options.output) {
+        file = std::fopen(options.output, options.binary ? "wb" : "w");
+        if (!file) {
+            std::perror(options.output);
+            return 1;
+        }
+    }
+
+    int threads = options.threads > 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    const uint64_t CHUNK_SIZE{64};
+    const uint64_t chunks = (options.count + CHUNK_SIZE - 1) / CHUNK_SIZE;
+
+    CensusWriter writer(file, options.binary);
+    std::atomic<uint64_t> nextChunk{0};
+    std::atomic<uint64_t> counts[3]{};
+    std::atomic<uint64_t> totalNodes{0};
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Each thread solves whole chunks of seeds with its own Solver
+    auto worker = [&]() {
+        Solver solver(options.ttBits);
+        CardId order[NUM_CARDS];
+        GameState state;
+        for (uint64_t chunk = nextChunk++; chunk < chunks && !writer.failed(); chunk = nextChunk++) {
+            uint64_t begin = options.first + chunk * CHUNK_SIZE;
+            uint64_t end = std::min(begin + CHUNK_SIZE, options.first + options.count);
+            std::vector<CensusRecord> records;
+            records.reserve(end - begin);
+            for (uint64_t seed = begin; seed < end; ++seed) {
+                shuffledDeck(seed, order);
+                state.deal(order);
+                SolveResult result = solver.solve(state, options.limits);
+                const SolverStats& stats = solver.stats();
+                records.push_back(CensusRecord{seed, stats.nodes, static_cast<uint32_t>(stats.seconds * 1e6), result});
+                counts[static_cast<int>(result)]++;
+                totalNodes += stats.nodes;
+            }
+            writer.add(chunk, std::move(records));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i) {
+        pool.emplace_back(worker);
+    }
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Buffered writes only fail for sure on the final flush
+    bool written = !writer.failed() && std::fflush(file) == 0 && !std::ferror(file);
+    if (file != stdout && std::fclose(file) != 0) {
+        written = false;
+    }
+    if (!written) {
+        std::fprintf(stderr, "census: could not write %s, the census is incomplete\n",
+                     options.output ? options.output : "standard output");
+        return 1;
+    }
+
+    uint64_t wins = counts[0];
+    uint64_t losses = counts[1];
+    uint64_t unknown = counts[2];
+    double deals = options.count ? static_cast<double>(options.count) : 1.0;
+    std::fprintf(stderr, "census: seeds %llu..%llu, %d threads, %.1f s, %.1f deals/s, %.2f M nodes/s\n",
+                 static_cast<unsigned long long>(options.first),
+                 static_cast<unsigned long long>(options.first + options.count - 1), threads, seconds,
+                 options.count / seconds, totalNodes / seconds / 1e6);
+    std::fprintf(stderr, "census: %llu win, %llu proven loss, %llu unknown, win rate %.2f%% .. %.2f%%\n",
+                 static_cast<unsigned long long>(wins), static_cast<unsigned long long>(losses),
+                 static_cast<unsigned long long>(unknown), 100.0 * wins / deals, 100.0 * (wins + unknown) / deals);
+    return 0;
+}
@@ -0,0 +1,491 @@
+/**
+  * @brief solitaire-engine-bench: throughput of the headless engine primitives
+  *
+  * Runs without Qt.  Usage:
+  *   solitaire-engine-bench [deals] [passes] [solves] [threads]
+  *                          [--json file] [--baseline file] [--tolerance percent]
+  *
+  * Every figure is also recorded as a rate, higher is better, and --json writes them
+  * to a file.  --baseline compares them with such a file from an earlier run, and the
+  * exit code is 1 if any rate dropped by more than the tolerance (default 10%), and 2
+  * on bad arguments or files.  The counts must be at least 1, threads 0 means one per
+  * core.  The hash update is timed as make/unmake with and without its XORs (see
+  * detail::makeMoveWithoutHash()) over the same moves.  The rules rate is the canAddCard()
+  * check that CardStack::canAdd() uses for every stack.
+  */
+#include "gamestate.h"
+#include "moves.h"
+#include "movesdetail.h"
+#include "parallelsolver.h"
+#include "rules.h"
+#include "shuffle.h"
+#include "solver.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock BenchClock;
+
+static const double DEFAULT_TOLERANCE{10.0};    ///< Percent a rate may drop before it is a regression
+
+/**
+ * @brief The Metric struct is one rate measured by the bench, higher is better
+ */
+struct Metric {
+    std::string name;
+    double perSecond;
+};
+
+static std::vector<Metric> metrics;
+
+static void record(const char *name, double perSecond)
+{
+    // A run too short to time would give inf or nan, which JSON cannot hold
+    if (std::isfinite(perSecond) && perSecond > 0.0) {
+        metrics.push_back(Metric{name, perSecond});
+    }
+}
+
+static double secondsSince(BenchClock::time_point start)
+{
+    return std::chrono::duration<double>(BenchClock::now() - start).count();
+}
+
+/**
+ * @brief makeCorpus - games #0 .. #deals-1, identical on every run and every machine
+ */
+static std::vector<GameState> makeCorpus(int deals)
+{
+    std::vector<GameState> corpus(deals);
+    CardId order[NUM_CARDS];
+    for (int i = 0; i < deals; ++i) {
+        shuffledDeck(static_cast<uint64_t>(i), order);
+        corpus[i].deal(order);
+    }
+    return corpus;
+}
+
+static void benchShuffle(int deals)
+{
+    CardId order[NUM_CARDS];
+    GameState state;
+    unsigned checksum{0};
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int i = 0; i < deals; ++i) {
+        shuffledDeck(static_cast<uint64_t>(i), order);
+        checksum += order[0];
+    }
+    double seconds = secondsSince(start);
+
+    std::printf("shuffle: %d decks in %.3f s, %.1f ns each (%u)\n", deals, seconds, seconds * 1e9 / deals, checksum);
+    record("shuffle_per_s", deals / seconds);
+
+    start = BenchClock::now();
+    for (int i = 0; i < deals; ++i) {
+        shuffledDeck(static_cast<uint64_t>(i), order);
+        state.deal(order);
+        checksum += static_cast<unsigned>(state.hash());
+    }
+    seconds = secondsSince(start);
+
+    std::printf("shuffle+deal: %d games in %.3f s, %.1f ns each (%u)\n", deals, seconds, seconds * 1e9 / deals, checksum);
+    record("shuffle_deal_per_s", deals / seconds);
+}
+
+static void benchMoveGeneration(const std::vector<GameState>& corpus, int passes)
+{
+    MoveList moves;
+    long long positions{0};
+    long long generated{0};
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const GameState& state : corpus) {
+            generated += generateMoves(state, moves);
+            positions++;
+        }
+    }
+    double seconds = secondsSince(start);
+
+    std::printf("movegen: %lld positions, %lld moves in %.3f s\n", positions, generated, seconds);
+    std::printf("movegen: %.2f M positions/s, %.2f M moves/s\n",
+                positions / seconds / 1e6, generated / seconds / 1e6);
+    record("movegen_positions_per_s", positions / seconds);
+}
+
+/**
+ * @brief benchRules - ask every pile of every position whether it takes every card
+ */
+static void benchRules(const std::vector<GameState>& corpus, int passes)
+{
+    long long checks{0};
+    long long accepted{0};
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const GameState& state : corpus) {
+            for (int p = PILE_FOUNDATION; p < NUM_PILES; ++p) {
+                for (int card = 0; card < NUM_CARDS; ++card) {
+                    accepted += canAddCard(state, static_cast<Pile>(p), static_cast<CardId>(card));
+                }
+            }
+            checks += (NUM_PILES - PILE_FOUNDATION) * NUM_CARDS;
+        }
+    }
+    double seconds = secondsSince(start);
+
+    std::printf("rules: %lld canAdd checks in %.3f s, %.2f M checks/s (%lld accepted)\n",
+                checks, seconds, checks / seconds / 1e6, accepted);
+    record("rules_can_add_per_s", checks / seconds);
+}
+
+/**
+ * @brief benchMakeUnmake - random playouts, making and unmaking every legal move on the way
+ */
+static void benchMakeUnmake(const std::vector<GameState>& corpus, int passes)
+{
+    const int PLAYOUT_LENGTH{100};
+    MoveList moves;
+    long long pairs{0};
+    std::mt19937 rng(54321);
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const GameState& deal : corpus) {
+            GameState state = deal;
+            for (int step = 0; step < PLAYOUT_LENGTH; ++step) {
+                if (generateMoves(state, moves) == 0) {
+                    break;
+                }
+                for (const Move& m : moves) {
+                    UndoInfo undoInfo = makeMove(state, m);
+                    unmakeMove(state, m, undoInfo);
+                    pairs++;
+                }
+                makeMove(state, moves[rng() % moves.size]);
+            }
+        }
+    }
+    double seconds = secondsSince(start);
+
+    std::printf("make/unmake: %lld pairs in %.3f s, %.2f M pairs/s\n", pairs, seconds, pairs / seconds / 1e6);
+    record("make_unmake_pairs_per_s", pairs / seconds);
+}
+
+/**
+ * @brief benchHashUpdate - make/unmake pairs with and without the incremental hash update
+ *
+ * The positions of random playouts and their legal moves are collected first, so both
+ * timed loops do exactly the same work apart from the hash XORs, and the difference is
+ * the update's own cost.
+ */
+static void benchHashUpdate(const std::vector<GameState>& corpus, int passes)
+{
+    const int PLAYOUT_LENGTH{100};
+    const size_t MAX_DEALS{1000};
+    std::vector<GameState> positions;
+    std::vector<Move> moves;
+    std::vector<size_t> firstMove;
+    MoveList list;
+    std::mt19937 rng(54321);
+
+    for (size_t d = 0; d < std::min(corpus.size(), MAX_DEALS); ++d) {
+        GameState state = corpus[d];
+        for (int step = 0; step < PLAYOUT_LENGTH && generateMoves(state, list) > 0; ++step) {
+            positions.push_back(state);
+            firstMove.push_back(moves.size());
+            moves.insert(moves.end(), list.begin(), list.end());
+            makeMove(state, list[rng() % list.size]);
+        }
+    }
+    firstMove.push_back(moves.size());
+
+    uint64_t checksum{0};
+    auto timePairs = [&](UndoInfo (*make)(GameState&, Move)) {
+        BenchClock::time_point start = BenchClock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (size_t p = 0; p < positions.size(); ++p) {
+                GameState state = positions[p];
+                for (size_t i = firstMove[p]; i < firstMove[p + 1]; ++i) {
+                    UndoInfo undoInfo = make(state, moves[i]);
+                    checksum += state.cardCount();
+                    unmakeMove(state, moves[i], undoInfo);
+                }
+            }
+        }
+        return secondsSince(start);
+    };
+    const double hashed = timePairs(makeMove);
+    const double unhashed = timePairs(detail::makeMoveWithoutHash);
+    const double pairs = double(moves.size()) * passes;
+
+    std::printf("hash update: %.0f make/unmake pairs, %.2f ns each with the hash, %.2f ns without (%llu)\n",
+                pairs, hashed * 1e9 / pairs, unhashed * 1e9 / pairs, static_cast<unsigned long long>(checksum));
+    std::printf("hash update: %.2f ns per move, %.1f%% of make/unmake\n",
+                (hashed - unhashed) * 1e9 / pairs, 100.0 * (hashed - unhashed) / hashed);
+    // The difference of two timings is too noisy to gate on, so only the rate is recorded
+    record("make_unmake_unhashed_pairs_per_s", pairs / unhashed);
+}
+
+/**
+ * @brief benchHashRecompute - cost of hashing a position from scratch, for comparison with
+ *        the incremental update done inside makeMove
+ */
+static void benchHashRecompute(const std::vector<GameState>& corpus, int passes)
+{
+    uint64_t combined{0};
+    long long hashes{0};
+
+    BenchClock::time_point start = BenchClock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        for (const GameState& state : corpus) {
+            combined += state.computeHash();
+            hashes++;
+        }
+    }
+    double seconds = secondsSince(start);
+
+    std::printf("hash recompute: %lld in %.3f s, %.1f ns each (%llx)\n", hashes, seconds,
+                seconds * 1e9 / hashes, static_cast<unsigned long long>(combined));
+    record("hash_recompute_per_s", hashes / seconds);
+}
+
+/**
+ * @brief benchSolver - solve the first deals of the corpus with a node budget per deal
+ */
+static void benchSolver(const std::vector<GameState>& corpus, int solves)
+{
+    const uint64_t NODE_BUDGET{2000000};
+    Solver solver;
+    SolverLimits limits;
+    limits.maxNodes = NODE_BUDGET;
+
+    int counts[3]{0, 0, 0};
+    uint64_t nodes{0};
+    uint64_t probes{0};
+    uint64_t hits{0};
+    double total{0.0};
+    std::vector<double> times;
+
+    solves = std::min<int>(solves, static_cast<int>(corpus.size()));
+    for (int i = 0; i < solves; ++i) {
+        SolveResult result = solver.solve(corpus[i], limits);
+        counts[static_cast<int>(result)]++;
+        nodes += solver.stats().nodes;
+        probes += solver.stats().ttProbes;
+        hits += solver.stats().ttHits;
+        total += solver.stats().seconds;
+        times.push_back(solver.stats().seconds);
+    }
+    if (solves == 0) {
+        return;
+    }
+    std::sort(times.begin(), times.end());
+
+    std::printf("solver: %d deals, %d win, %d loss, %d unknown (budget %llu nodes)\n", solves,
+                counts[0], counts[1], counts[2], static_cast<unsigned long long>(NODE_BUDGET));
+    std::printf("solver: median %.2f ms, mean %.2f ms, %llu nodes, %.2f M nodes/s, TT hit rate %.1f%%\n",
+                times[times.size() / 2] * 1e3, total / solves * 1e3, static_cast<unsigned long long>(nodes),
+                nodes / total / 1e6, probes ? 100.0 * hits / probes : 0.0);
+    record("solver_nodes_per_s", nodes / total);
+}
+
+/**
+ * @brief benchParallelSolver - solve the same deals sequentially and on a thread pool
+ *
+ * Both searches get the same node budget, counted over all threads for the parallel
+ * one, so unknown deals cost about the same work either way.
+ */
+static void benchParallelSolver(const std::vector<GameState>& corpus, int solves, int threads)
+{
+    const uint64_t NODE_BUDGET{2000000};
+    Solver solver;
+    ParallelSolver parallel(threads);
+    SolverLimits limits;
+    limits.maxNodes = NODE_BUDGET;
+
+    int counts[3]{0, 0, 0};
+    uint64_t nodes{0};
+    uint64_t tasks{0};
+    uint64_t steals{0};
+    double sequentialTime{0.0};
+    double parallelTime{0.0};
+
+    solves = std::min<int>(solves, static_cast<int>(corpus.size()));
+    for (int i = 0; i < solves; ++i) {
+        solver.solve(corpus[i], limits);
+        sequentialTime += solver.stats().seconds;
+
+        SolveResult result = parallel.solve(corpus[i], limits);
+        counts[static_cast<int>(result)]++;
+        nodes += parallel.stats().nodes;
+        tasks += parallel.stats().tasks;
+        steals += parallel.stats().steals;
+        parallelTime += parallel.stats().seconds;
+    }
+    if (solves == 0) {
+        return;
+    }
+
+    std::printf("parallel solver: %d threads, %d deals, %d win, %d loss, %d unknown\n", parallel.threadCount(),
+                solves, counts[0], counts[1], counts[2]);
+    std::printf("parallel solver: %.2f M nodes/s, %llu tasks, %llu steals\n", nodes / parallelTime / 1e6,
+                static_cast<unsigned long long>(tasks), static_cast<unsigned long long>(steals));
+    std::printf("parallel solver: %.3f s vs %.3f s sequential, speedup %.2fx\n",
+                parallelTime, sequentialTime, sequentialTime / parallelTime);
+    record("parallel_solver_nodes_per_s", nodes / parallelTime);
+}
+
+/**
+ * @brief writeJson - the recorded rates and the run parameters, one metric per line
+ */
+static bool writeJson(const char *path, int deals, int passes, int solves, int threads)
+{
+    FILE *file = std::fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+    std::fprintf(file, "{\n  \"bench\": \"solitaire-engine-bench\",\n");
+    std::fprintf(file, "  \"deals\": %d,\n  \"passes\": %d,\n  \"solves\": %d,\n  \"threads\": %d,\n",
+                 deals, passes, solves, threads);
+    std::fprintf(file, "  \"metrics\": {\n");
+    for (size_t i = 0; i < metrics.size(); ++i) {
+        std::fprintf(file, "    \"%s\": %.1f%s\n", metrics[i].name.c_str(), metrics[i].perSecond,
+                     i + 1 < metrics.size() ? "," : "");
+    }
+    std::fprintf(file, "  }\n}\n");
+    return std::fclose(file) == 0;
+}
+
+/**
+ * @brief readBaseline - the metrics of a file written by writeJson()
+ *
+ * Only reads the one-metric-per-line layout writeJson() produces, not JSON in general.
+ */
+static bool readBaseline(const char *path, std::map<std::string, double>& baseline)
+{
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    bool inMetrics{false};
+    while (std::getline(in, line)) {
+        char name[64];
+        double value;
+        if (line.find("\"metrics\"") != std::string::npos) {
+            inMetrics = true;
+        } else if (inMetrics && std::sscanf(line.c_str(), " \"%63[^\"]\": %lf", name, &value) == 2) {
+            baseline[name] = value;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief compareBaseline - print each rate against the baseline
+ *
+ * @return the number of rates that dropped by more than tolerance percent
+ */
+static int compareBaseline(const std::map<std::string, double>& baseline, double tolerance)
+{
+    int regressions{0};
+    std::printf("baseline: tolerance %.1f%%\n", tolerance);
+    for (const Metric& metric : metrics) {
+        auto it = baseline.find(metric.name);
+        if (it == baseline.end() || it->second <= 0.0) {
+            std::printf("  %-34s %14.1f    (not in baseline)\n", metric.name.c_str(), metric.perSecond);
+            continue;
+        }
+        const double change = 100.0 * (metric.perSecond - it->second) / it->second;
+        const bool regressed = change < -tolerance;
+        regressions += regressed;
+        std::printf("  %-34s %14.1f vs %14.1f  %+6.1f%%%s\n", metric.name.c_str(), metric.perSecond,
+                    it->second, change, regressed ? "  REGRESSION" : "");
+    }
+    return regressions;
+}
+
+static void usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [deals] [passes] [solves] [threads]\n"
+                 "          [--json file] [--baseline file] [--tolerance percent]\n"
+                 "deals, passes and solves are at least 1, threads 0 means one per core\n", program);
+}
+
+/**
+ * @brief parseCount - text as a whole number no less than minimum
+ */
+static bool parseCount(const char *text, int minimum, int& value)
+{
+    char *end{nullptr};
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || parsed < minimum || parsed > 1000000000L) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *jsonPath{nullptr};
+    const char *baselinePath{nullptr};
+    double tolerance{DEFAULT_TOLERANCE};
+    int counts[4]{10000, 200, 100, 0};          // deals, passes, solves, threads
+    int numbers{0};
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else if (numbers >= 4 || !parseCount(argv[i], numbers == 3 ? 0 : 1, counts[numbers])) {
+            usage(argv[0]);
+            return 2;
+        } else {
+            numbers++;
+        }
+    }
+    const int deals = counts[0];
+    const int passes = counts[1];
+    const int solves = counts[2];
+    const int threads = counts[3];
+
+    std::map<std::string, double> baseline;
+    if (baselinePath && !readBaseline(baselinePath, baseline)) {
+        std::fprintf(stderr, "Cannot read baseline %s\n", baselinePath);
+        return 2;
+    }
+
+    benchShuffle(deals * 100);
+    std::vector<GameState> corpus = makeCorpus(deals);
+    benchMoveGeneration(corpus, passes);
+    benchRules(corpus, std::max(1, passes / 10));
+    benchMakeUnmake(corpus, std::max(1, passes / 100));
+    benchHashUpdate(corpus, std::max(1, passes / 100));
+    benchHashRecompute(corpus, passes);
+    benchSolver(corpus, solves);
+    benchParallelSolver(corpus, solves, threads);
+
+    if (jsonPath && !writeJson(jsonPath, deals, passes, solves, threads)) {
+        std::fprintf(stderr, "Cannot write %s\n", jsonPath);
+        return 2;
+    }
+    if (baselinePath && compareBaseline(baseline, tolerance) > 0) {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,571 @@
+/**
+  * @brief solitaire-render-bench: cost of creating and painting the cards
+  *
+  * create: builds decks of cards the old way, where every card had QGraphicsSvgItem
+  *   children that each parsed their own SVG file, and as Card items.  The first deck is
+  *   the cost paid at startup; resident memory is read before and after.
+  * paint: renders frames of a scene holding a fanned out deck, once with the per card
+  *   drawing Card::paint and its SVG children used to do on every repaint, and once
+  *   with Card painting from the CardAtlas.
+  * drag: the picture of a dragged run, made fresh and taken from the cache.
+  * columns: all 52 cards dealt out on the tableau, shown in a view with one item per
+  *   card and with each column as one item (DescendingStack column mode).  Every frame
+  *   flips a top card, then repaints the whole view and just the flipped card.
+  * suite: scripted scenarios on the real Game in a MainWindow, each repeated until it
+  *   has rendered at least [frames] frames of the game view into a QImage: the 52 card
+  *   fan of a shuffle, full table repaints with per-card items and with column mode,
+  *   dragging a 13 card run around, and New Game with its animation.  Animations are
+  *   stepped SUITE_FRAME_MS per frame instead of running on the clock.  Prints JSON only:
+  *   frames per second, paint() calls per frame and frame time percentiles per scenario.
+  *
+  * Usage: solitaire-render-bench [decks] [frames] [all|per-item|cards|paint|drag|columns|suite]
+  * Anything else on the command line prints the usage and exits with 2.
+  * Runs on the offscreen platform unless QT_QPA_PLATFORM is set.  Run one create mode
+  * per process for the cleanest memory numbers.  "all" does not include the suite.
+  */
+#include "card.h"
+#include "cardanimator.h"
+#include "cardatlas.h"
+#include "cardstack.h"
+#include "constants.h"
+#include "game.h"
+#include "gamestate.h"
+#include "mainwindow.h"
+#include "perfhud.h"
+#include "renderstats.h"
+#include "svgcache.h"
+#include "tablelayout.h"
+
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QGraphicsScene>
+#include <QGraphicsSceneMouseEvent>
+#include <QGraphicsSvgItem>
+#include <QGraphicsView>
+#include <QImage>
+#include <QPainter>
+#include <QSvgRenderer>
+#include <QUndoStack>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+static const char *FACE_IMAGES[] {
+    ":/images/King-Hearts.svg",   ":/images/Queen-Hearts.svg",   ":/images/Jack-Hearts.svg",
+    ":/images/King-Diamonds.svg", ":/images/Queen-Diamonds.svg", ":/images/Jack-Diamonds.svg",
+    ":/images/King-Spades.svg",   ":/images/Queen-Spades.svg",   ":/images/Jack-Spades.svg",
+    ":/images/King-Clubs.svg",    ":/images/Queen-Clubs.svg",    ":/images/Jack-Clubs.svg",
+};
+
+/**
+ * @brief makeDeckPerItem - the SVG items of one deck as Card used to build them
+ */
+static void makeDeckPerItem(std::vector<std::unique_ptr<QGraphicsSvgItem>>& items)
+{
+    for (int i = 0; i < NUM_CARDS; ++i) {
+        items.emplace_back(new QGraphicsSvgItem(":/images/Card-Back.svg"));
+    }
+    for (const char *path : FACE_IMAGES) {
+        items.emplace_back(new QGraphicsSvgItem(path));
+    }
+}
+
+static void makeDeckCards(std::vector<std::unique_ptr<Card>>& cards)
+{
+    for (Suit suit : SuitIterator()) {
+        for (CardValue value : CardValueIterator()) {
+            cards.emplace_back(new Card(value, suit));
+        }
+    }
+}
+
+template <typename Items, typename MakeDeck>
+static void run(const char *name, int decks, Items& items, MakeDeck makeDeck)
+{
+    long startKB = PerfHud::residentKB();
+    QElapsedTimer timer;
+
+    timer.start();
+    makeDeck(items);
+    double firstMs = timer.nsecsElapsed() / 1e6;
+    long firstKB = PerfHud::residentKB();
+
+    timer.start();
+    for (int d = 1; d < decks; ++d) {
+        makeDeck(items);
+    }
+    double restMs = timer.nsecsElapsed() / 1e6;
+    long endKB = PerfHud::residentKB();
+
+    std::printf("%-9s first deck %8.2f ms, %6ld KB", name, firstMs, firstKB - startKB);
+    if (decks > 1) {
+        std::printf(" | next %d decks %8.3f ms, %6.1f KB each", decks - 1,
+                    restMs / (decks - 1), double(endKB - firstKB) / (decks - 1));
+    }
+    std::printf(" | RSS %ld KB\n", endKB);
+}
+
+/**
+ * @brief paintLegacy - what one repaint of a card cost before the atlas: two antialiased
+ *        rounded rectangles, then the text or an SVG render
+ */
+static void paintLegacy(QPainter *painter, CardId id)
+{
+    const QRectF rect(-(CARD_WIDTH/2), -(CARD_HEIGHT/2), CARD_WIDTH, CARD_HEIGHT);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(Qt::darkGray);
+    painter->drawRoundedRect(rect, CARD_RADIUS, CARD_RADIUS);
+    painter->setPen(QPen(Qt::black, 1));
+    painter->setBrush(QBrush(Qt::white));
+    painter->drawRoundedRect(rect, CARD_RADIUS, CARD_RADIUS);
+
+    if (const char *path = CardAtlas::imagePath(id)) {
+        QSvgRenderer *renderer = SvgCache::renderer(path);
+        painter->save();
+        painter->translate(QPointF(-(CARD_WIDTH/2), -3-(CARD_HEIGHT/2)) * (1.0 - SVG_SCALEF));
+        painter->scale(SVG_SCALEF, SVG_SCALEF);
+        renderer->render(painter, QRectF(QPointF(0, 0), renderer->defaultSize()));
+        painter->restore();
+    } else {
+        painter->setPen(isRedCard(id) ? Qt::red : Qt::black);
+        painter->drawText(QPoint{-(CARD_WIDTH/2)+SHDW+1, -(CARD_WIDTH/2)+SHDW+1}, Card::cardText(id));
+    }
+}
+
+static QPointF fanPosition(int index)
+{
+    return QPointF(CARD_WIDTH + (index % CARDS_PER_SUIT) * (CARD_WIDTH / 2 + 8),
+                   CARD_HEIGHT + (index / CARDS_PER_SUIT) * (CARD_HEIGHT + 10));
+}
+
+static void benchPaint(int frames)
+{
+    QImage frame(GAME_WIDTH, GAME_HEIGHT, QImage::Format_ARGB32_Premultiplied);
+    QElapsedTimer timer;
+
+    timer.start();
+    CardAtlas::atlas(1.0);
+    double atlasMs = timer.nsecsElapsed() / 1e6;
+    timer.start();
+    CardAtlas::atlas(2.0);
+    std::printf("atlas: %.2f ms at 1x, %.2f ms at 2x\n", atlasMs, timer.nsecsElapsed() / 1e6);
+
+    timer.start();
+    for (int f = 0; f < frames; ++f) {
+        frame.fill(Qt::darkGreen);
+        QPainter painter(&frame);
+        painter.setRenderHint(QPainter::Antialiasing);
+        for (int id = 0; id < NUM_CARDS; ++id) {
+            painter.save();
+            painter.translate(fanPosition(id));
+            paintLegacy(&painter, static_cast<CardId>(id));
+            painter.restore();
+        }
+    }
+    double legacyMs = timer.nsecsElapsed() / 1e6 / frames;
+
+    QGraphicsScene scene(0, 0, GAME_WIDTH, GAME_HEIGHT);
+    for (Suit suit : SuitIterator()) {
+        for (CardValue value : CardValueIterator()) {
+            Card *card = new Card(value, suit);
+            card->setPos(fanPosition(card->cardId()));
+            scene.addItem(card);
+        }
+    }
+
+    timer.start();
+    for (int f = 0; f < frames; ++f) {
+        frame.fill(Qt::darkGreen);
+        QPainter painter(&frame);
+        painter.setRenderHint(QPainter::Antialiasing);
+        scene.render(&painter);
+    }
+    double atlasFrameMs = timer.nsecsElapsed() / 1e6 / frames;
+
+    std::printf("paint: %d frames of %d cards, legacy %.3f ms/frame, atlas %.3f ms/frame, %.1fx\n",
+                frames, NUM_CARDS, legacyMs, atlasFrameMs, legacyMs / atlasFrameMs);
+}
+
+static void benchDrag(int frames)
+{
+    const int RUN_LENGTH{12};
+    CardAtlas::atlas(1.0);
+
+    // A different run every time, so none of them come from the cache
+    QElapsedTimer timer;
+    timer.start();
+    for (int f = 0; f < frames; ++f) {
+        const int first = f % NUM_CARDS;
+        const int step = 1 + (f / NUM_CARDS) % (NUM_CARDS - 1);
+        QVector<CardId> run;
+        for (int i = 0; i < RUN_LENGTH; ++i) {
+            run.append(static_cast<CardId>((first + i * step) % NUM_CARDS));
+        }
+        CardAtlas::runPixmap(run, 1.0);
+    }
+    double coldUs = timer.nsecsElapsed() / 1e3 / frames;
+
+    QVector<CardId> run;
+    for (int i = 0; i < RUN_LENGTH; ++i) {
+        run.append(static_cast<CardId>(i));
+    }
+    CardAtlas::runPixmap(run, 1.0);
+    timer.start();
+    for (int f = 0; f < frames; ++f) {
+        CardAtlas::runPixmap(run, 1.0);
+    }
+    double warmUs = timer.nsecsElapsed() / 1e3 / frames;
+
+    std::printf("drag: %d card run picture, fresh %.1f us, cached %.2f us (frame budget 16667 us)\n",
+                RUN_LENGTH, coldUs, warmUs);
+}
+
+/**
+ * @brief itemsDrawn - number of visible items Qt paints or blits for a repaint of rect
+ */
+static int itemsDrawn(const QGraphicsScene& scene, const QRectF& rect)
+{
+    const QList<QGraphicsItem*> items = scene.items(rect);
+    return std::count_if(items.begin(), items.end(), [](QGraphicsItem *item) { return item->isVisible(); });
+}
+
+static void benchColumns(int frames)
+{
+    CardAtlas::atlas(1.0);
+
+    // Deal all the cards out, dealer style, so the view is the busiest tableau there is
+    CardId columns[NUM_PLAY_STACKS][MAX_COLUMN];
+    int sizes[NUM_PLAY_STACKS]{};
+    for (int id = 0; id < NUM_CARDS; ++id) {
+        const int c = id % NUM_PLAY_STACKS;
+        columns[c][sizes[c]++] = static_cast<CardId>(id);
+    }
+    GameState state;
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        state.setPile(tableauPile(c), columns[c], sizes[c], c);
+    }
+
+    QGraphicsScene scene(0, 0, GAME_WIDTH, GAME_HEIGHT);
+    QUndoStack *undoStack = new QUndoStack;
+    Card *cards[NUM_CARDS];
+    for (int id = 0; id < NUM_CARDS; ++id) {
+        cards[id] = new Card(cardValue(static_cast<CardId>(id)), cardSuit(static_cast<CardId>(id)));
+    }
+    DescendingStack *stacks[NUM_PLAY_STACKS];
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        stacks[c] = new DescendingStack(nullptr, undoStack);
+        stacks[c]->attachModel(&state, cards, tableauPile(c));
+        stacks[c]->setPos(TableLayout::pilePos(tableauPile(c)));
+        scene.addItem(stacks[c]);
+        stacks[c]->syncFromModel();
+    }
+
+    QGraphicsView view(&scene);
+    view.setFixedSize(GAME_WIDTH, GAME_HEIGHT);
+    view.show();
+    QApplication::processEvents();
+    QWidget *viewport = view.viewport();
+
+    for (bool columnMode : {false, true}) {
+        for (DescendingStack *stack : stacks) {
+            stack->setColumnMode(columnMode);
+        }
+        viewport->repaint();
+
+        const int fullItems = itemsDrawn(scene, view.mapToScene(viewport->rect()).boundingRect());
+        int cardItems{0};
+        QElapsedTimer timer;
+        qint64 fullNs{0};
+        qint64 cardNs{0};
+        for (int f = 0; f < frames; ++f) {
+            // A flip changes the column, the stack would be touched by its SceneTransaction
+            const int c = f % NUM_PLAY_STACKS;
+            Card *top = cards[state.top(tableauPile(c))];
+            top->setFaceUp(!top->isFaceUp());
+            stacks[c]->update();
+
+            timer.start();
+            viewport->repaint();
+            fullNs += timer.nsecsElapsed();
+
+            top->setFaceUp(!top->isFaceUp());
+            stacks[c]->update();
+            const QRectF cardRect = top->sceneBoundingRect();
+            cardItems += itemsDrawn(scene, cardRect);
+
+            timer.start();
+            viewport->repaint(view.mapFromScene(cardRect).boundingRect());
+            cardNs += timer.nsecsElapsed();
+        }
+
+        std::printf("columns: %-8s full view %3d items %8.3f ms/frame | one card %5.1f items %8.3f ms/frame\n",
+                    columnMode ? "column" : "per-card", fullItems, fullNs / 1e6 / frames,
+                    double(cardItems) / frames, cardNs / 1e6 / frames);
+    }
+}
+
+static const int SUITE_FRAME_MS{16};        ///< Animation time stepped per suite frame, about 60 Hz
+static const quint64 SUITE_SEED{1};         ///< Game number of the first deal of the suite
+static const int DRAG_STEPS{40};            ///< Pointer moves per drag in the suite
+
+/**
+ * @brief The SuiteResult struct holds the measurements of one suite scenario
+ */
+struct SuiteResult {
+    std::string name;
+    int iterations{0};
+    std::vector<qint64> frameNs{};
+    quint64 paints{0};
+};
+
+/**
+ * @brief renderFrame - run step, then paint the game view into frame, timed as one frame
+ */
+static void renderFrame(Game *game, QImage& frame, SuiteResult& result, const std::function<void()>& step)
+{
+    frame.fill(Qt::transparent);
+    const quint64 paints = RenderStats::paints();
+    QElapsedTimer timer;
+    timer.start();
+    step();
+    game->viewport()->render(&frame);
+    result.frameNs.push_back(timer.nsecsElapsed());
+    result.paints += RenderStats::paints() - paints;
+}
+
+/**
+ * @brief renderAnimation - render every frame of the running CardAnimator, until it stops
+ */
+static void renderAnimation(Game *game, QImage& frame, SuiteResult& result)
+{
+    CardAnimator *animator = CardAnimator::instance();
+    int time{0};
+    while (animator->state() == QAbstractAnimation::Running) {
+        time += SUITE_FRAME_MS;
+        renderFrame(game, frame, result, [animator, time]() { animator->setCurrentTime(time); });
+    }
+}
+
+/**
+ * @brief sendMouse - a left button mouse event to the game's scene, as the view would send it
+ */
+static void sendMouse(Game *game, QEvent::Type type, const QPointF& scenePos, const QPointF& downPos)
+{
+    QWidget *viewport = game->viewport();
+    QGraphicsSceneMouseEvent event(type);
+    event.setScenePos(scenePos);
+    event.setScreenPos(viewport->mapToGlobal(game->mapFromScene(scenePos)));
+    event.setButtonDownScenePos(Qt::LeftButton, downPos);
+    event.setButtonDownScreenPos(Qt::LeftButton, viewport->mapToGlobal(game->mapFromScene(downPos)));
+    event.setButton(type == QEvent::GraphicsSceneMouseMove ? Qt::NoButton : Qt::LeftButton);
+    event.setButtons(type == QEvent::GraphicsSceneMouseRelease ? Qt::NoButton : Qt::LeftButton);
+    QApplication::sendEvent(game->scene(), &event);
+}
+
+/**
+ * @brief runPosition - King to Ace of alternating colours in the first column, ready to drag
+ */
+static GameState runPosition()
+{
+    GameState state;
+    bool used[NUM_CARDS]{};
+    CardId run[CARDS_PER_SUIT];
+    for (int i = 0; i < CARDS_PER_SUIT; ++i) {
+        const Suit suit = (i % 2) ? Suit::HEART : Suit::SPADE;
+        run[i] = makeCardId(suit, static_cast<CardValue>(CARDS_PER_SUIT - i));
+        used[run[i]] = true;
+    }
+    state.setPile(tableauPile(0), run, CARDS_PER_SUIT, 0);
+
+    // The other cards fill the hand, then columns of one card more each from the second on
+    CardId rest[NUM_CARDS];
+    int count{0};
+    for (int id = 0; id < NUM_CARDS; ++id) {
+        if (!used[id]) {
+            rest[count++] = static_cast<CardId>(id);
+        }
+    }
+    state.setPile(PILE_HAND, rest, MAX_TALON, MAX_TALON);
+    int next{MAX_TALON};
+    for (int c = 1; next < count; ++c) {
+        const int size = std::min(c, count - next);
+        state.setPile(tableauPile(c), &rest[next], size, size - 1);
+        next += size;
+    }
+    return state;
+}
+
+static double percentileMs(const std::vector<qint64>& sorted, double percent)
+{
+    const size_t rank = std::min(sorted.size() - 1, size_t(percent / 100.0 * sorted.size()));
+    return sorted[rank] / 1e6;
+}
+
+static void printSuiteResult(const SuiteResult& result, bool last)
+{
+    std::vector<qint64> sorted = result.frameNs;
+    std::sort(sorted.begin(), sorted.end());
+    qint64 totalNs{0};
+    for (qint64 ns : sorted) {
+        totalNs += ns;
+    }
+    const double frames = double(sorted.size());
+    std::printf("    {\"name\": \"%s\", \"iterations\": %d, \"frames\": %zu, \"fps\": %.1f, "
+                "\"paintsPerFrame\": %.1f,\n"
+                "     \"frameMs\": {\"mean\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}}%s\n",
+                result.name.c_str(), result.iterations, sorted.size(), frames / (totalNs / 1e9),
+                result.paints / frames, totalNs / 1e6 / frames, percentileMs(sorted, 50),
+                percentileMs(sorted, 90), percentileMs(sorted, 99), sorted.back() / 1e6, last ? "" : ",");
+}
+
+/**
+ * @brief benchSuite - time the scripted scenarios on the real Game, see the top of the file
+ */
+static void benchSuite(int frames)
+{
+    MainWindow window;
+    window.show();
+    Game *game = window.game();
+    game->resize(GAME_WIDTH + 2*game->frameWidth(), GAME_HEIGHT + 2*game->frameWidth());
+    QApplication::processEvents();
+
+    CardAnimator *animator = CardAnimator::instance();
+    QImage frame(game->viewport()->size() * game->devicePixelRatioF(), QImage::Format_ARGB32_Premultiplied);
+    frame.setDevicePixelRatio(game->devicePixelRatioF());
+    RenderStats::setEnabled(true);
+    std::vector<SuiteResult> results;
+
+    // The deck is only full, and fanned out by a shuffle, before the first game is dealt
+    results.push_back(SuiteResult{"fan-52"});
+    while (results.back().frameNs.size() < size_t(frames)) {
+        game->shuffle(SUITE_SEED + results.back().iterations++);
+        renderAnimation(game, frame, results.back());
+    }
+
+    for (bool columnMode : {false, true}) {
+        game->setColumnRendering(columnMode);
+        game->newGame(SUITE_SEED);
+        animator->finishAll();
+        results.push_back(SuiteResult{columnMode ? "full-table-column" : "full-table"});
+        while (results.back().frameNs.size() < size_t(frames)) {
+            results.back().iterations++;
+            renderFrame(game, frame, results.back(), []() {});
+        }
+    }
+    game->setColumnRendering(false);
+
+    // Pick the run up by its King, take it across the table and back, and drop it where it was
+    game->setState(runPosition());
+    const QPointF king = TableLayout::cardPos(tableauPile(0), 0) - QPointF(0, (CARD_HEIGHT - CARD_OVERLAP)/2.0);
+    const QPointF across(3 * TableLayout::COLUMN_PITCH, CARD_HEIGHT/2.0);
+    results.push_back(SuiteResult{"drag-13"});
+    while (results.back().frameNs.size() < size_t(frames)) {
+        SuiteResult& result = results.back();
+        result.iterations++;
+        sendMouse(game, QEvent::GraphicsSceneMousePress, king, king);
+        for (int i = 1; i <= DRAG_STEPS; ++i) {
+            const double t = double(i) / DRAG_STEPS;
+            const QPointF pos = king + across * (t < 0.5 ? 2*t : 2 - 2*t);
+            renderFrame(game, frame, result, [game, pos, king]() {
+                sendMouse(game, QEvent::GraphicsSceneMouseMove, pos, king);
+            });
+        }
+        renderFrame(game, frame, result, [game, king]() {
+            sendMouse(game, QEvent::GraphicsSceneMouseRelease, king, king);
+        });
+    }
+
+    results.push_back(SuiteResult{"new-game"});
+    while (results.back().frameNs.size() < size_t(frames)) {
+        SuiteResult& result = results.back();
+        const quint64 gameNumber = SUITE_SEED + result.iterations++;
+        renderFrame(game, frame, result, [game, gameNumber]() { game->newGame(gameNumber); });
+        renderAnimation(game, frame, result);
+    }
+    RenderStats::setEnabled(false);
+
+    std::printf("{\n  \"platform\": \"%s\",\n  \"qt\": \"%s\",\n  \"view\": [%d, %d],\n"
+                "  \"stepMs\": %d,\n  \"scenarios\": [\n",
+                qPrintable(QGuiApplication::platformName()), qVersion(),
+                game->viewport()->width(), game->viewport()->height(), SUITE_FRAME_MS);
+    for (size_t i = 0; i < results.size(); ++i) {
+        printSuiteResult(results[i], i + 1 == results.size());
+    }
+    std::printf("  ]\n}\n");
+}
+
+static const char *MODES[]{"all", "per-item", "cards", "paint", "drag", "columns", "suite"};
+
+static void usage(const char *program)
+{
+    std::fprintf(stderr,
+                 "Usage: %s [decks] [frames] [all|per-item|cards|paint|drag|columns|suite]\n"
+                 "decks and frames are at least 1\n", program);
+}
+
+/**
+ * @brief parseCount - text as a whole number of at least 1
+ */
+static bool parseCount(const char *text, int& value)
+{
+    char *end{nullptr};
+    long parsed = std::strtol(text, &end, 10);
+    if (end == text || *end != '\0' || parsed < 1 || parsed > 1000000000L) {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    int decks{20};
+    int frames{200};
+    const char *mode = argc > 3 ? argv[3] : "all";
+    const bool knownMode = std::any_of(std::begin(MODES), std::end(MODES),
+                                       [mode](const char *m) { return std::strcmp(mode, m) == 0; });
+    if (argc > 4 || (argc > 1 && !parseCount(argv[1], decks)) ||
+            (argc > 2 && !parseCount(argv[2], frames)) || !knownMode) {
+        usage(argv[0]);
+        return 2;
+    }
+    bool all = std::strcmp(mode, "all") == 0;
+
+    if (std::strcmp(mode, "suite") == 0) {
+        benchSuite(frames);
+        return 0;
+    }
+
+    std::printf("render bench: %d decks, RSS at start %ld KB\n", decks, PerfHud::residentKB());
+
+    if (all || std::strcmp(mode, "per-item") == 0) {
+        std::vector<std::unique_ptr<QGraphicsSvgItem>> items;
+        run("per-item", decks, items, makeDeckPerItem);
+    }
+    if (all || std::strcmp(mode, "cards") == 0) {
+        std::vector<std::unique_ptr<Card>> cards;
+        run("cards", decks, cards, makeDeckCards);
+    }
+    if (all || std::strcmp(mode, "paint") == 0) {
+        benchPaint(frames);
+    }
+    if (all || std::strcmp(mode, "drag") == 0) {
+        benchDrag(frames);
+    }
+    if (all || std::strcmp(mode, "columns") == 0) {
+        benchColumns(frames);
+    }
+    return 0;
+}
@@ -0,0 +1,181 @@
+#include "trace.h"
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+
+std::atomic<bool> Trace::sEnabled{false};
+
+namespace {
+
+struct TraceEvent {
+    const char *category;
+    const char *name;
+    uint64_t startNs;
+    uint64_t durationNs;
+};
+
+/*
+ * One thread's spans.  Only the owning thread writes events; written is the number of
+ * events ever recorded, stored with release after each one so a dump from another
+ * thread sees complete events (bar the few being overwritten while it reads).
+ * A buffer outlives its thread, so its spans still get dumped, and is only handed to a
+ * new thread once clear() has emptied it.
+ */
+struct TraceBuffer {
+    std::array<TraceEvent, Trace::BUFFER_EVENTS> events;
+    std::atomic<uint64_t> written{0};
+    std::atomic<bool> owned{true};
+    int threadId{0};
+    std::string threadName;
+};
+
+std::mutex sBuffersLock;                    ///< Guards sBuffers and the thread names
+std::vector<TraceBuffer*> sBuffers;
+thread_local const char *tThreadName{nullptr};
+
+TraceBuffer* claimBuffer()
+{
+    std::lock_guard<std::mutex> lock(sBuffersLock);
+    TraceBuffer *claimed{nullptr};
+    for (TraceBuffer *buffer : sBuffers) {
+        bool expected{false};
+        if (buffer->written.load(std::memory_order_acquire) == 0 &&
+            buffer->owned.compare_exchange_strong(expected, true)) {
+            claimed = buffer;
+            break;
+        }
+    }
+    if (!claimed) {
+        claimed = new TraceBuffer;
+        claimed->threadId = static_cast<int>(sBuffers.size()) + 1;
+        sBuffers.push_back(claimed);
+    }
+    claimed->threadName = tThreadName ? tThreadName : "";
+    return claimed;
+}
+
+/*
+ * The calling thread's buffer, claimed on its first span and released when it exits.
+ */
+class ThreadBuffer
+{
+public:
+    ThreadBuffer() : mBuffer{claimBuffer()} {}
+    ~ThreadBuffer() { mBuffer->owned.store(false); }
+    TraceBuffer* get() const { return mBuffer; }
+
+private:
+    TraceBuffer *mBuffer;
+};
+
+ThreadBuffer& threadBuffer()
+{
+    thread_local ThreadBuffer buffer;
+    return buffer;
+}
+
+void writeJsonString(FILE *file, const char *text)
+{
+    std::fputc('"', file);
+    for (const char *c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+        }
+        std::fputc(*c, file);
+    }
+    std::fputc('"', file);
+}
+
+} // namespace
+
+void Trace::setEnabled(bool enabled)
+{
+    sEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Trace::nowNs()
+{
+    typedef std::chrono::steady_clock Clock;
+    static const Clock::time_point epoch = Clock::now();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch).count());
+}
+
+/**
+ * @brief record - add a finished span to the calling thread's ring buffer
+ */
+void Trace::record(const char *category, const char *name, uint64_t startNs, uint64_t endNs)
+{
+    TraceBuffer *buffer = threadBuffer().get();
+    const uint64_t n = buffer->written.load(std::memory_order_relaxed);
+    buffer->events[n % BUFFER_EVENTS] = TraceEvent{category, name, startNs, endNs - startNs};
+    buffer->written.store(n + 1, std::memory_order_release);
+}
+
+/**
+ * @brief setThreadName - name the calling thread's track in the trace viewer
+ *
+ * Call it when the thread starts, before its first span.  Threads that record nothing
+ * get no buffer, so this costs nothing while tracing is off.
+ */
+void Trace::setThreadName(const char *name)
+{
+    tThreadName = name;
+}
+
+/**
+ * @brief clear - forget every span recorded so far
+ *
+ * Only call while no thread is recording.
+ */
+void Trace::clear()
+{
+    std::lock_guard<std::mutex> lock(sBuffersLock);
+    for (TraceBuffer *buffer : sBuffers) {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
+
+/**
+ * @brief dump - write every thread's kept spans to path as Chrome trace_event JSON
+ *
+ * @return false if the file could not be written
+ */
+bool Trace::dump(const char *path)
+{
+    FILE *file = std::fopen(path, "w");
+    if (!file) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(sBuffersLock);
+    std::fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    bool first{true};
+    for (const TraceBuffer *buffer : sBuffers) {
+        if (!buffer->threadName.empty()) {
+            std::fprintf(file, "%s{\"ph\": \"M\", \"name\": \"thread_name\", \"pid\": 1, \"tid\": %d, \"args\": {\"name\": ",
+                         first ? "" : ",\n", buffer->threadId);
+            writeJsonString(file, buffer->threadName.c_str());
+            std::fprintf(file, "}}");
+            first = false;
+        }
+
+        const uint64_t written = buffer->written.load(std::memory_order_acquire);
+        const uint64_t begin = written > uint64_t(BUFFER_EVENTS) ? written - BUFFER_EVENTS : 0;
+        for (uint64_t n = begin; n < written; ++n) {
+            const TraceEvent& event = buffer->events[n % BUFFER_EVENTS];
+            std::fprintf(file, "%s{\"ph\": \"X\", \"pid\": 1, \"tid\": %d, \"ts\": %.3f, \"dur\": %.3f, \"cat\": ",
+                         first ? "" : ",\n", buffer->threadId, event.startNs / 1e3, event.durationNs / 1e3);
+            writeJsonString(file, event.category);
+            std::fprintf(file, ", \"name\": ");
+            writeJsonString(file, event.name);
+            std::fprintf(file, "}");
+            first = false;
+        }
+    }
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
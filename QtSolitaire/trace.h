@@ -0,0 +1,78 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief The Trace class records timed spans for Chrome's trace_event format
+ *
+ * Spans are written by TraceSpan (use the TRACE_SPAN macro) into a ring buffer of the
+ * thread they run on, so recording takes no lock: each thread owns its buffer and only
+ * publishes how far it has written with an atomic store.  The newest BUFFER_EVENTS
+ * spans of every thread are kept.  dump() writes them as JSON that chrome://tracing
+ * and Perfetto load.
+ *
+ * Plain C++ so the engine's solver threads can be traced too.  While tracing is off a
+ * span costs one relaxed load and a branch; building with SOLITAIRE_TRACING off removes
+ * the spans altogether.  Names and categories must be string literals, or otherwise
+ * outlive the dump.
+ */
+class Trace
+{
+public:
+    Trace() = delete;
+
+    static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+
+    static uint64_t nowNs();
+    static void record(const char *category, const char *name, uint64_t startNs, uint64_t endNs);
+    static void setThreadName(const char *name);
+    static void clear();
+    static bool dump(const char *path);
+
+    static const int BUFFER_EVENTS{1 << 14};     ///< Spans kept per thread
+
+private:
+    static std::atomic<bool> sEnabled;
+};
+
+/**
+ * @brief The TraceSpan class records the time from its construction to its destruction
+ */
+class TraceSpan
+{
+public:
+    TraceSpan(const char *category, const char *name)
+        : mCategory{category}
+        , mName{Trace::isEnabled() ? name : nullptr}
+        , mStartNs{mName ? Trace::nowNs() : 0}
+    {
+    }
+    ~TraceSpan()
+    {
+        if (mName) {
+            Trace::record(mCategory, mName, mStartNs, Trace::nowNs());
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+    const char *mCategory;
+    const char *mName;          ///< nullptr while tracing is off
+    uint64_t mStartNs;
+};
+
+#define TRACE_CONCAT_(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_(a, b)
+
+#ifdef SOLITAIRE_TRACING
+#define TRACE_SPAN(category, name) TraceSpan TRACE_CONCAT(traceSpan, __LINE__)(category, name)
+#else
+#define TRACE_SPAN(category, name) do {} while (false)
+#endif
+
+#endif // TRACE_H
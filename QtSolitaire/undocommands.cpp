@@ -1,497 +1,197 @@
 #include "undocommands.h"
 #include "cardstack.h"
+#include "logging.h"
+#include "scenetransaction.h"
+#include "trace.h"
 
-/******************************************************************************
- * Hand Click Undo Command Implementation
- *****************************************************************************/
-HandToWasteCommand::HandToWasteCommand(RandomStack *hand, RandomStack *wastePile)
-    : mHand{hand}
-    , mWastePile{wastePile}
-{
-}
-
-
-/**
- * @brief undo move single card from hand to waste pile
- */
-void HandToWasteCommand::undo() {
-
-    Card *topCard{nullptr};
-    if (!mHand || !mWastePile) {
-        qDebug() << "Bad parameter in HandClickUndoCommand";
-        return;
-    }
-    if (mWastePile->isEmpty()) {
-        return;
-    }
-    topCard = mWastePile->takeTop();
-    qDebug() << "Undo" << text();
-    topCard->setFaceUp(false);
-    mHand->addCard(topCard, false);
-}
+#include <QDebug>
 
 /**
- * @brief redo move single card from hand to waste pile
+ * @brief runLength - number of cards from card to the top of stack, or 0 if card is not in stack
  */
-void HandToWasteCommand::redo() {
-
-    Card *topCard{nullptr};
-    if (!mHand || !mWastePile) {
-        qDebug() << "Bad parameter in HandClickUndoCommand";
-        return;
-    }
-    if (mHand->isEmpty()) {
-        return;
-    }
-    topCard = mHand->takeTop();
-    if (this->text().isEmpty()) {
-        QString text = "Move " + topCard->getText() + " to Waste Pile";
-        this->setText(text);
+static int runLength(CardStack *stack, Card *card)
+{
+    if (!stack || !card) {
+        return 0;
     }
-
-    qDebug() << "Redo " << text();
-
-    topCard->setFaceUp(true);
-    mWastePile->addCard(topCard, false);
+    int index = stack->cards().indexOf(card);
+    return index < 0 ? 0 : stack->cards().size() - index;
 }
 
 /******************************************************************************
- * Reset Hand Command Implementation - Move Waste Pile back to Hand
+ * Move Command Implementation
  *****************************************************************************/
-ResetHandCommand::ResetHandCommand(RandomStack *hand, RandomStack *wastePile)
-    : mHand{hand}
-    , mWastePile{wastePile}
-{
-    this->setText("Reset hand from Waste pile");
-}
-
 /**
- * @brief undo move entire waste pile back to the hand
+ * The command only takes the move if generateMoves() offers it in the current position,
+ * so an illegal request leaves mMove null and can never reach makeMove().
  */
-void ResetHandCommand::undo() {
-
-    Card *card{nullptr};
-    if (!mHand || !mWastePile) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-    if (mHand->isEmpty()) {
-        return;
+MoveCommand::MoveCommand(CardStack *from, CardStack *to, int count)
+    : mFrom{from}
+    , mTo{to}
+    , mMove{}
+    , mUndoInfo{}
+{
+    if (mFrom && mTo && mFrom->model() && count > 0) {
+        MoveList moves;
+        generateMoves(*mFrom->model(), moves);
+        for (const Move& m : moves) {
+            if (m.from() == mFrom->pile() && m.to() == mTo->pile() && m.count() == count) {
+                mMove = m;
+                break;
+            }
+        }
     }
-    qDebug() << "Undo" << text();
-    while (!mHand->isEmpty()) {
-        card = mHand->takeTop();
-        card->setFaceUp(true);             // Ensure new top of stack face down
-        mWastePile->addCard(card, false);
+    if (mMove.isNull()) {
+        qCWarning(lcUndo) << "Illegal move of" << count << "cards from pile"
+                          << (mFrom ? int(mFrom->pile()) : -1) << "to" << (mTo ? int(mTo->pile()) : -1);
     }
 }
 
 /**
- * @brief redo move entire waste pile back to the hand
+ * @brief movedCardItem - scene item of the (bottom) card this command moves, valid before redo()
  */
-void ResetHandCommand::redo() {
-
-    Card *card{nullptr};
-
-    if (!mHand || !mWastePile) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    qDebug() << "Redo " << text();
-    while (!mWastePile->isEmpty()) {
-        card = mWastePile->takeTop();
-        card->setFaceUp(false);             // Ensure new top of stack face down
-        mHand->addCard(card, false);
+Card* MoveCommand::movedCardItem() const
+{
+    if (mMove.isNull()) {
+        return nullptr;
     }
+    return mFrom->cardItem(movedCard(*mFrom->model(), mMove));
 }
 
-
-/******************************************************************************
- * Move to Playfield Undo Command Implementation
- *****************************************************************************/
-MoveToPlayfieldCommand::MoveToPlayfieldCommand(RandomStack *wastePile, DescendingStack *dStack)
-    : mTopFlipped{false}
-    , mWastePile{wastePile}
-    , mDStack{dStack}
+void MoveCommand::syncStacks()
 {
+    SceneTransaction transaction(mFrom->scene());
+    mFrom->syncFromModel();
+    mTo->syncFromModel();
 }
 
-
 /**
- * @brief undo moves entire waste pile back to the hand
+ * @brief undo take the move back on the model, and show the result
  */
-void MoveToPlayfieldCommand::undo() {
+void MoveCommand::undo() {
+    TRACE_SPAN("undo", "MoveCommand::undo");
 
-    Card *card{nullptr};
-    if (!mWastePile || !mDStack) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-    if (mDStack->isEmpty()) {
+    if (mMove.isNull()) {
         return;
     }
-    qDebug() << "Undo" << text();
-    card = mDStack->takeTop();
-    mWastePile->addCard(card, mWastePile->isTopFlipped());
+    qCDebug(lcUndo) << "Undo" << text();
+    unmakeMove(*mFrom->model(), mMove, mUndoInfo);
+    syncStacks();
 }
 
 /**
- * @brief redo moves entire waste pile back to the hand
+ * @brief redo play the move on the model, and show the result
  */
-void MoveToPlayfieldCommand::redo() {
-
-    Card *card{nullptr};
+void MoveCommand::redo() {
+    TRACE_SPAN("undo", "MoveCommand::redo");
 
-    if (!mWastePile || !mDStack) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
+    if (mMove.isNull()) {
+        // QUndoStack::push() deletes an obsolete command instead of keeping it
+        setObsolete(true);
         return;
     }
+    qCDebug(lcUndo) << "Redo" << text();
+    mUndoInfo = makeMove(*mFrom->model(), mMove);
+    syncStacks();
+}
 
-    card = mWastePile->takeTop();
-    if (card && text().isEmpty()) {
-        QString text = "Move " + card->getText() + " to playfield";
-        setText(text);
+/******************************************************************************
+ * Hand Click Undo Command Implementation - move single card from hand to waste pile
+ *****************************************************************************/
+HandToWasteCommand::HandToWasteCommand(RandomStack *hand, RandomStack *wastePile)
+    : MoveCommand(hand, wastePile, 1)
+{
+    if (Card *card = movedCardItem()) {
+        setText("Move " + card->getText() + " to Waste Pile");
     }
-    qDebug() << "Redo " << text();
-
-    mDStack->addCard(card, false);
 }
 
 /******************************************************************************
- * Waste Pile to Foundation Command Implementation
+ * Reset Hand Command Implementation - Move Waste Pile back to Hand
  *****************************************************************************/
-WasteToFoundationCommand::WasteToFoundationCommand(RandomStack *wastePile, SortedStack *sStack)
-    : mTopFlipped{false}
-    , mWastePile{wastePile}
-    , mSStack{sStack}
+ResetHandCommand::ResetHandCommand(RandomStack *hand, RandomStack *wastePile)
+    : MoveCommand(wastePile, hand, wastePile ? wastePile->cards().size() : 0)
 {
+    this->setText("Reset hand from Waste pile");
 }
 
-/**
- * @brief undo move single card from waste pile to foundation
- */
-void WasteToFoundationCommand::undo() {
-
-    Card *card{nullptr};
-    if (!mWastePile || !mSStack) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-    if (mSStack->isEmpty()) {
-        return;
+/******************************************************************************
+ * Move to Playfield Undo Command Implementation - single card from waste pile to playfield
+ *****************************************************************************/
+MoveToPlayfieldCommand::MoveToPlayfieldCommand(RandomStack *wastePile, DescendingStack *dStack)
+    : MoveCommand(wastePile, dStack, 1)
+{
+    if (Card *card = movedCardItem()) {
+        setText("Move " + card->getText() + " to playfield");
     }
-    qDebug() << "Undo" << text();
-    card = mSStack->takeTop();
-    mWastePile->addCard(card, mWastePile->isTopFlipped());
 }
 
-/**
- * @brief redo move single card from waste pile to foundation
- */
-void WasteToFoundationCommand::redo() {
-
-    Card *card{nullptr};
-
-    if (!mWastePile || !mSStack) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    card = mWastePile->takeTop();
-    if (card && text().isEmpty()) {
-        QString text = "Move " + card->getText() + " to foundation";
-        setText(text);
+/******************************************************************************
+ * Waste Pile to Foundation Command Implementation
+ *****************************************************************************/
+WasteToFoundationCommand::WasteToFoundationCommand(RandomStack *wastePile, SortedStack *sStack)
+    : MoveCommand(wastePile, sStack, 1)
+{
+    if (Card *card = movedCardItem()) {
+        setText("Move " + card->getText() + " to foundation");
     }
-    qDebug() << "Redo " << text();
-    mSStack->addCard(card, false);
 }
 
 /******************************************************************************
  * Playfield to Foundation Command Implementation
  *****************************************************************************/
 PlayfieldToFoundationCommand::PlayfieldToFoundationCommand(DescendingStack *playfield, SortedStack *sStack)
-    : mTopFlipped{false}
-    , mPlayfieldStack{playfield}
-    , mSStack{sStack}
+    : MoveCommand(playfield, sStack, 1)
 {
-}
-
-/**
- * @brief undo move single card from waste pile to foundation
- */
-void PlayfieldToFoundationCommand::undo() {
-
-    Card *card{nullptr};
-    if (!mPlayfieldStack || !mSStack) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-    if (mSStack->isEmpty()) {
-        return;
-    }
-    qDebug() << "Undo" << text();
-    card = mSStack->takeTop();
-    mPlayfieldStack->addCard(card, mTopFlipped);
-}
-
-/**
- * @brief redo move single card from waste pile to foundation
- */
-void PlayfieldToFoundationCommand::redo() {
-
-    Card *card{nullptr};
-
-    if (!mPlayfieldStack || !mSStack) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    card = mPlayfieldStack->takeTop();
-    if (card && text().isEmpty()) {
-        QString text = "Move " + card->getText() + " to foundation";
-        setText(text);
-        mTopFlipped = mPlayfieldStack->isTopFlipped();
+    if (Card *card = movedCardItem()) {
+        setText("Move " + card->getText() + " to foundation");
     }
-    qDebug() << "Redo " << text();
-
-    mSStack->addCard(card, false);
 }
 
 /******************************************************************************
- * Playfield to Playfield Undo Command Implementation
+ * Playfield to Playfield Undo Command Implementation - click to move single card
  *****************************************************************************/
 PlayfieldToPlayfieldCommand::PlayfieldToPlayfieldCommand(DescendingStack *playfieldFrom, DescendingStack *playfieldTo)
-    : mTopFlipped{false}
-    , mPlayfieldFrom{playfieldFrom}
-    , mPlayfieldTo{playfieldTo}
+    : MoveCommand(playfieldFrom, playfieldTo, 1)
 {
-}
-
-/**
- * @brief Undo click to move single card from one playfield column to another
- */
-void PlayfieldToPlayfieldCommand::undo() {
-
-    Card *card{nullptr};
-    if (!mPlayfieldFrom || !mPlayfieldTo) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-    if (mPlayfieldTo->isEmpty()) {
-        return;
+    if (Card *card = movedCardItem()) {
+        setText("Move " + card->getText() + " from stack to stack");
     }
-    qDebug() << "Undo" << text();
-    card = mPlayfieldTo->takeTop();
-
-    if (!mPlayfieldFrom->isEmpty() && mTopFlipped) {
-    }
-    mPlayfieldFrom->addCard(card, mTopFlipped);
-}
-
-/**
- * @brief Redo click to move single card from one playfield column to another
- */
-void PlayfieldToPlayfieldCommand::redo() {
-
-    Card *card{nullptr};
-
-    if (!mPlayfieldFrom || !mPlayfieldTo) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    card = mPlayfieldFrom->takeTop();
-    if (card && text().isEmpty()) {
-        QString text = "Move " + card->getText() + " from stack to stack";
-        setText(text);
-        mTopFlipped = mPlayfieldFrom->isTopFlipped();
-    }
-    qDebug() << "Redo " << text();
-    mPlayfieldTo->addCard(card, false);
 }
 
 /******************************************************************************
- * Drag Playfield to Playfield Undo Command Implementation
+ * Drag Playfield to Playfield Undo Command Implementation - one or more cards
  *****************************************************************************/
 DragPlayfieldToPlayfieldCommand::DragPlayfieldToPlayfieldCommand(Card *droppedCard, DescendingStack *playfieldFrom, DescendingStack *playfieldTo)
-    : mTopFlipped{false}
-    , mDroppedCard(droppedCard)
-    , mPlayfieldFrom{playfieldFrom}
-    , mPlayfieldTo{playfieldTo}
+    : MoveCommand(playfieldFrom, playfieldTo, runLength(playfieldFrom, droppedCard))
 {
-}
-
-/**
- * @brief Undo Drag move one or more cards from one playfield column to another
- */
-void DragPlayfieldToPlayfieldCommand::undo() {
-
-    Card *card{nullptr};
-    QList<Card*> tempCards;
-    bool firstCard = true;
-
-    if (!mDroppedCard || !mPlayfieldFrom || !mPlayfieldTo) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-    if (mPlayfieldTo->isEmpty()) {
-        return;
-    }
-    qDebug() << "Undo" << text();
-
-    tempCards = mPlayfieldTo->takeCards(*mDroppedCard);
-    while (!tempCards.isEmpty()) {
-        card = tempCards.takeFirst();
-
-        if (firstCard) {
-            firstCard = false;
-            mPlayfieldFrom->addCard(card, mTopFlipped);
-        } else {
-            mPlayfieldFrom->addCard(card, false);
-        }
-        card->update();
-    }
-}
-
-/**
- * @brief Redo Drag move one or more cards from one playfield column to another
- */
-void DragPlayfieldToPlayfieldCommand::redo() {
-
-    Card *card{nullptr};
-    QList<Card*> tempCards;
-    int numDragged{0};
-
-    if (!mDroppedCard || !mPlayfieldFrom || !mPlayfieldTo) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    tempCards = mPlayfieldFrom->takeCards(*mDroppedCard);
-    while (!tempCards.isEmpty()) {
-        card = tempCards.takeFirst();
-        mPlayfieldTo->addCard(card, false);
-        card->update();
-        numDragged++;
+    if (Card *card = movedCardItem()) {
+        int numDragged = mMove.count();
+        setText(QString("Drag %1 card%2 starting with %3 to other stack")
+                    .arg(numDragged)
+                    .arg( (numDragged > 1) ? "s" : "")
+                    .arg(card->getText()));
     }
-    if (text().isEmpty()) {
-        QString text = QString("Drag %1 card%2 starting with %3 to other stack")
-                           .arg(numDragged)
-                           .arg( (numDragged > 1) ? "s" : "")
-                           .arg(mDroppedCard->getText());
-        setText(text);
-        mTopFlipped = mPlayfieldFrom->isTopFlipped();
-    }
-
-    qDebug() << "Redo " << text();
 }
 
 /******************************************************************************
  * Drag Waste to Playfield Undo Command Implementation
- *
- * NOTE: really does not care about top flipped, because the stacks involved
- *       always have the cards above the movement already face up
  *****************************************************************************/
 DragWasteToPlayfieldCommand::DragWasteToPlayfieldCommand(RandomStack *wasteFrom, DescendingStack *playfieldTo)
-    : mWasteFrom{wasteFrom}
-    , mPlayfieldTo{playfieldTo}
+    : MoveCommand(wasteFrom, playfieldTo, 1)
 {
-}
-
-/**
- * @brief Undo Drag move one or more cards from one playfield column to another
- */
-void DragWasteToPlayfieldCommand::undo() {
-
-    Card *card{nullptr};
-
-    if (!mWasteFrom || !mPlayfieldTo) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
+    if (Card *card = movedCardItem()) {
+        setText(QString("Drag  %1 to playfield").arg(card->getText()));
     }
-    if (mPlayfieldTo->isEmpty()) {
-        return;
-    }
-
-    qDebug() << "Undo" << text();
-    card = mPlayfieldTo->takeTop();
-    mWasteFrom->addCard(card, false);
-}
-
-/**
- * @brief Redo Drag move one or more cards from one playfield column to another
- */
-void DragWasteToPlayfieldCommand::redo() {
-
-    Card *card{nullptr};
-
-    if (!mWasteFrom || !mPlayfieldTo) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    card = mWasteFrom->takeTop();
-    if (text().isEmpty()) {
-        QString text = QString("Drag  %1 to playfield")
-                           .arg(card->getText());
-        setText(text);
-    }
-    mPlayfieldTo->addCard(card, false);
-
-    qDebug() << "Redo " << text();
 }
 
 /******************************************************************************
- * Drag Playfield to Foundation Undo Command Implementation
+ * Drag Foundation to Playfield Undo Command Implementation
  *****************************************************************************/
 DragFoundationToPlayfieldCommand::DragFoundationToPlayfieldCommand(SortedStack *foundationFrom, DescendingStack *playfieldTo )
-    : mTopFlipped{false}
-    , mFoundationFrom{foundationFrom}
-    , mPlayfieldTo{playfieldTo}
+    : MoveCommand(foundationFrom, playfieldTo, 1)
 {
-}
-
-/**
- * @brief Undo click to move single card from one playfield column to another
- */
-void DragFoundationToPlayfieldCommand::undo() {
-
-    Card *card{nullptr};
-
-    if (!mPlayfieldTo|| !mFoundationFrom) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
+    if (Card *card = movedCardItem()) {
+        setText("Drag " + card->getText() + " from foundation to playfield");
     }
-    if (mPlayfieldTo->isEmpty()) {
-        return;
-    }
-    qDebug() << "Undo" << text();
-    card = mPlayfieldTo->takeTop();
-    mFoundationFrom->addCard(card, mTopFlipped);
 }
-
-/**
- * @brief Redo click to move single card from one playfield column to another
- */
-void DragFoundationToPlayfieldCommand::redo() {
-
-    Card *card{nullptr};
-
-    if (!mPlayfieldTo || !mFoundationFrom) {
-        qDebug() << "Bad parameter in " << __FUNCTION__;
-        return;
-    }
-
-    card = mFoundationFrom->takeTop();
-    if (card && text().isEmpty()) {
-        QString text = "Drag " + card->getText() + " from foundation to playfield";
-        setText(text);
-        if (!mPlayfieldTo->isEmpty()) {
-            mTopFlipped = mPlayfieldTo->isTopFlipped();
-        }
-    }
-    qDebug() << "Redo " << text();
-    mPlayfieldTo->addCard(card, false);
-}
-
@@ -1,144 +1,103 @@
 #ifndef CARDUNDOCOMMAND_H
 #define CARDUNDOCOMMAND_H
 
+#include "moves.h"
+
 #include <QUndoCommand>
 
 class Card;
+class CardStack;
 class RandomStack;
 class DescendingStack;
 class SortedStack;
 
 QT_FORWARD_DECLARE_CLASS(QGraphicsItem);
+
 /**
- * @brief The HandClickUndoCommand - Undo command for clicking on the hand pile
+ * @brief The MoveCommand - Undo command that plays one Move on the game model
+ *
+ * redo() and undo() run makeMove/unmakeMove on the model shared by the stacks, then
+ * re-sync the two stacks involved.  The subclasses below only describe which Move
+ * they are, and build their text once in the constructor.  A move the rules do not
+ * allow leaves the command null: it changes nothing and push() discards it.
  */
-class HandToWasteCommand : public QUndoCommand
+class MoveCommand : public QUndoCommand
 {
 public:
-    HandToWasteCommand(RandomStack *hand, RandomStack *wastePile);
+    MoveCommand(CardStack *from, CardStack *to, int count);
 
     void undo() override;
     void redo() override;
 
-private:
-    bool mTopFlipped;
-    RandomStack *mHand;
-    RandomStack *mWastePile;
+protected:
+    Card* movedCardItem() const;
+    void syncStacks();
+
+    CardStack *mFrom;
+    CardStack *mTo;
+    Move mMove;
+    UndoInfo mUndoInfo;
 };
 
-class ResetHandCommand : public QUndoCommand
+/**
+ * @brief The HandToWasteCommand - Undo command for clicking on the hand pile
+ */
+class HandToWasteCommand : public MoveCommand
 {
 public:
-    ResetHandCommand(RandomStack *hand, RandomStack *wastePile);
-
-    void undo() override;
-    void redo() override;
+    HandToWasteCommand(RandomStack *hand, RandomStack *wastePile);
+};
 
-private:
-    RandomStack *mHand;
-    RandomStack *mWastePile;
+class ResetHandCommand : public MoveCommand
+{
+public:
+    ResetHandCommand(RandomStack *hand, RandomStack *wastePile);
 };
 
 
-class MoveToPlayfieldCommand : public QUndoCommand
+class MoveToPlayfieldCommand : public MoveCommand
 {
 public:
     MoveToPlayfieldCommand(RandomStack *wastePile, DescendingStack *dStack);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    bool mTopFlipped;
-    RandomStack *mWastePile;
-    DescendingStack *mDStack;
 };
 
 
-class WasteToFoundationCommand : public QUndoCommand
+class WasteToFoundationCommand : public MoveCommand
 {
 public:
     WasteToFoundationCommand(RandomStack *wastePile, SortedStack *sStack);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    bool mTopFlipped;
-    RandomStack *mWastePile;
-    SortedStack *mSStack;
 };
 
-class PlayfieldToFoundationCommand : public QUndoCommand
+class PlayfieldToFoundationCommand : public MoveCommand
 {
 public:
     PlayfieldToFoundationCommand(DescendingStack *playfield, SortedStack *sStack);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    bool mTopFlipped;
-    DescendingStack *mPlayfieldStack;
-    SortedStack *mSStack;
 };
 
 
-class PlayfieldToPlayfieldCommand : public QUndoCommand
+class PlayfieldToPlayfieldCommand : public MoveCommand
 {
 public:
     PlayfieldToPlayfieldCommand(DescendingStack *playfieldFrom, DescendingStack *playfieldTo);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    bool mTopFlipped;
-    DescendingStack *mPlayfieldFrom;
-    DescendingStack *mPlayfieldTo;
 };
 
-class DragPlayfieldToPlayfieldCommand : public QUndoCommand
+class DragPlayfieldToPlayfieldCommand : public MoveCommand
 {
 public:
     DragPlayfieldToPlayfieldCommand(Card *droppedCard, DescendingStack *playfieldFrom, DescendingStack *playfieldTo);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    bool mTopFlipped;
-    Card *mDroppedCard;
-    DescendingStack *mPlayfieldFrom;
-    DescendingStack *mPlayfieldTo;
 };
 
-class DragWasteToPlayfieldCommand : public QUndoCommand
+class DragWasteToPlayfieldCommand : public MoveCommand
 {
 public:
     DragWasteToPlayfieldCommand(RandomStack *mWasteFrom, DescendingStack *playfieldTo);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    RandomStack *mWasteFrom;
-    DescendingStack *mPlayfieldTo;
 };
 
 
-class DragFoundationToPlayfieldCommand : public QUndoCommand
+class DragFoundationToPlayfieldCommand : public MoveCommand
 {
 public:
     DragFoundationToPlayfieldCommand(SortedStack *foundationFrom,DescendingStack *playfieldTo);
-
-    void undo() override;
-    void redo() override;
-
-private:
-    bool mTopFlipped;
-    DescendingStack *mPlayfieldTo;
-    SortedStack *mFoundationFrom;
 };
 
 #endif // CARDUNDOCOMMAND_H
@@ -0,0 +1,33 @@
+#include "zobrist.h"
+#include "prng.h"
+
+static constexpr ZobristKeys makeZobristKeys()
+{
+    ZobristKeys keys{};
+    uint64_t seed{0x5017A1BE};
+
+    for (int k = 0; k < MAX_TALON; ++k) {
+        for (int card = 0; card < NUM_CARDS; ++card) {
+            keys.talon[k][card] = splitMix64(seed);
+        }
+    }
+    for (int n = 0; n <= MAX_TALON; ++n) {
+        keys.wasteSize[n] = splitMix64(seed);
+    }
+    for (int c = 0; c < NUM_PLAY_STACKS; ++c) {
+        for (int d = 0; d < MAX_COLUMN; ++d) {
+            for (int card = 0; card < NUM_CARDS; ++card) {
+                keys.tableau[c][d][card][0] = splitMix64(seed);
+                keys.tableau[c][d][card][1] = splitMix64(seed);
+            }
+        }
+    }
+    for (int s = 0; s < NUM_SUITS; ++s) {
+        for (int n = 0; n <= CARDS_PER_SUIT; ++n) {
+            keys.foundation[s][n] = splitMix64(seed);
+        }
+    }
+    return keys;
+}
+
+constexpr ZobristKeys ZOBRIST = makeZobristKeys();
@@ -0,0 +1,31 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include "gamestate.h"
+
+#include <cstdint>
+
+/**
+ * @brief ZobristKeys are the random 64 bit keys XORed together to hash a GameState
+ *
+ * A position's hash is the XOR of one key for every (card, pile, depth, face up) fact
+ * about it, so makeMove only touches the keys of the cards it moves.
+ *  - talon[k][card]: card at slot k of the shared hand/waste array (hand and waste
+ *    cards are always face down and face up respectively)
+ *  - wasteSize[n]: the boundary between waste and hand, the "stock pointer"
+ *  - tableau[column][depth][card][faceUp]
+ *  - foundation[suit][count]
+ *
+ * The keys are generated at compile time from a fixed seed, so hashes are identical in
+ * every build and on every machine.
+ */
+struct ZobristKeys {
+    uint64_t talon[MAX_TALON][NUM_CARDS];
+    uint64_t wasteSize[MAX_TALON + 1];
+    uint64_t tableau[NUM_PLAY_STACKS][MAX_COLUMN][NUM_CARDS][2];
+    uint64_t foundation[NUM_SUITS][CARDS_PER_SUIT + 1];
+};
+
+extern const ZobristKeys ZOBRIST;
+
+#endif // ZOBRIST_H